@@ -0,0 +1,134 @@
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local uint64_t thread_count = 0;
+std::atomic<uint64_t> total_count{0};
+
+void count_allocation() {
+    thread_count++;
+    total_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+namespace alloc_counter {
+
+uint64_t thread_allocations() {
+    return thread_count;
+}
+
+uint64_t total_allocations() {
+    return total_count.load(std::memory_order_relaxed);
+}
+
+}  // namespace alloc_counter
+
+// ==================== C 할당 함수 대체 (glibc) ====================
+// 실제 할당은 glibc의 __libc_* 구현에 위임. free는 세지 않으므로 대체하지 않음
+#ifdef __GLIBC__
+#define ALLOC_COUNTER_C_ALLOC 1
+
+extern "C" {
+
+void* __libc_malloc(size_t size) noexcept;
+void* __libc_calloc(size_t count, size_t size) noexcept;
+void* __libc_realloc(void* p, size_t size) noexcept;
+void* __libc_memalign(size_t alignment, size_t size) noexcept;
+void* __libc_valloc(size_t size) noexcept;
+void* __libc_pvalloc(size_t size) noexcept;
+
+void* malloc(size_t size) noexcept {
+    count_allocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    count_allocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, size_t size) noexcept {
+    count_allocation();
+    return __libc_realloc(p, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) noexcept {
+    // alignment는 sizeof(void*)의 배수인 2의 거듭제곱이어야 함
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+    count_allocation();
+    void* p = __libc_memalign(alignment, size);
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+void* valloc(size_t size) noexcept {
+    count_allocation();
+    return __libc_valloc(size);
+}
+
+void* pvalloc(size_t size) noexcept {
+    count_allocation();
+    return __libc_pvalloc(size);
+}
+
+}  // extern "C"
+#else
+#define ALLOC_COUNTER_C_ALLOC 0
+#endif
+
+// ==================== operator new/delete 대체 ====================
+// new[], nothrow 버전은 기본 구현이 이것을 호출
+// 정렬 new(alignas > 16)는 libstdc++ 기본 구현이 위를 거치지 않으므로 별도로 대체
+// C 할당 함수를 대체한 경우 malloc/aligned_alloc에서 세므로 여기서는 세지 않음
+void* operator new(std::size_t size) {
+    if (!ALLOC_COUNTER_C_ALLOC) count_allocation();
+    if (size == 0) size = 1;
+    void* p = std::malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+    std::free(p);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (!ALLOC_COUNTER_C_ALLOC) count_allocation();
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (align < sizeof(void*)) align = sizeof(void*);
+    if (size == 0) size = 1;
+    // aligned_alloc은 size가 alignment의 배수여야 함
+    size = (size + align - 1) & ~(align - 1);
+    void* p = std::aligned_alloc(align, size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p, std::align_val_t /*alignment*/) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept {
+    std::free(p);
+}
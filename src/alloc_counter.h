@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// ==================== 힙 할당 카운터 ====================
+// 전역 operator new와 (glibc에서) C 할당 함수 malloc/calloc/realloc/memalign/
+// posix_memalign/aligned_alloc/valloc/pvalloc을 대체해 할당 횟수를 센다 (alloc_counter.cpp).
+// 실행 파일이 정의한 malloc 계열은 동적 심볼 해석으로 FFTW, stdio, GLFW, libbladeRF 등
+// 공유 라이브러리 안의 호출까지 가로채므로 "어떤 힙 할당이든" 센다.
+// 세지 못하는 것: mmap을 직접 호출하는 메모리(스레드 스택 등), glibc가 아닌 환경의 C 할당
+// (그때는 operator new만 센다).
+// 스윕/렌더 경로가 워밍업 이후 힙 할당을 하지 않는지 확인하는 데 사용.
+namespace alloc_counter {
+
+// 호출한 스레드의 누적 할당 횟수
+uint64_t thread_allocations();
+
+// 전체 스레드의 누적 할당 횟수
+uint64_t total_allocations();
+
+}  // namespace alloc_counter
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <fftw3.h>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// ==================== FFT 플랜/윈도우 캐시 ====================
+// RBW(FFT 크기)와 윈도우 종류를 실행 중에 바꿀 수 있도록
+// 크기별 FFTW 플랜과 (크기, 윈도우 종류)별 윈도우/PFB 필터/보정값을 한 번만 만들어 보관한다.
+// FFTW 플래너는 스레드 안전하지 않으므로 스윕 스레드에서만 사용할 것.
+
+enum WindowType {
+    WINDOW_HANN = 0,
+    WINDOW_BLACKMAN_HARRIS,
+    WINDOW_FLAT_TOP,
+    WINDOW_TYPE_COUNT
+};
+
+inline const char* window_type_name(int type) {
+    switch (type) {
+        case WINDOW_HANN:            return "Hann";
+        case WINDOW_BLACKMAN_HARRIS: return "Blackman-Harris";
+        case WINDOW_FLAT_TOP:        return "Flat-top";
+        default:                     return "?";
+    }
+}
+
+// 크기별 FFT 플랜 (입출력 버퍼 포함)
+struct FftPlan {
+    int size;
+    fftw_complex* in;
+    fftw_complex* out;
+    fftw_plan plan;
+
+    explicit FftPlan(int n) : size(n) {
+        in = fftw_alloc_complex(n);
+        out = fftw_alloc_complex(n);
+        plan = fftw_plan_dft_1d(n, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
+    }
+
+    ~FftPlan() {
+        fftw_destroy_plan(plan);
+        fftw_free(in);
+        fftw_free(out);
+    }
+
+    FftPlan(const FftPlan&) = delete;
+    FftPlan& operator=(const FftPlan&) = delete;
+};
+
+inline double window_coeff(WindowType type, int i, int n) {
+    double x = 2.0 * M_PI * i / (n - 1);
+    switch (type) {
+        case WINDOW_BLACKMAN_HARRIS:
+            return 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2 * x) - 0.01168 * cos(3 * x);
+        case WINDOW_FLAT_TOP:
+            return 0.21557895 - 0.41663158 * cos(x) + 0.277263158 * cos(2 * x)
+                   - 0.083578947 * cos(3 * x) + 0.006947368 * cos(4 * x);
+        case WINDOW_HANN:
+        default:
+            return 0.5 * (1.0 - cos(x));
+    }
+}
+
+// (크기, 윈도우 종류)별 윈도우 계수와 파워 손실 보정 (dB)
+// taps > 1이면 PFB(WOLA) 프로토타입 필터: 길이 taps * size의 윈도우된 sinc
+// (통과대역 폭 bin_width 빈 → 1보다 크게 잡아 빈 경계에서도 평탄, 스캘럽 손실 제거)
+// 보정값은 FFT 크기 기준 잡음 파워 정규화 (10log10(Σw² / size))
+struct FftWindow {
+    int size;
+    int taps;
+    WindowType type;
+    std::vector<float> coeffs;
+    float correction;
+
+    FftWindow(int n, WindowType window_type, int num_taps = 1, double bin_width = 1.0)
+        : size(n), taps(num_taps), type(window_type), coeffs((size_t)n * num_taps) {
+        int length = n * num_taps;
+        double center = (length - 1) / 2.0;
+        for (int i = 0; i < length; i++) {
+            double w = window_coeff(window_type, i, length);
+            if (num_taps > 1) {
+                double t = (i - center) / n * bin_width;
+                w *= (t == 0.0) ? 1.0 : sin(M_PI * t) / (M_PI * t);
+            }
+            coeffs[i] = (float)w;
+        }
+
+        double power_sum = 0.0;
+        for (int i = 0; i < length; i++) {
+            power_sum += (double)coeffs[i] * coeffs[i];
+        }
+        correction = (float)(10.0 * log10(power_sum / n));
+    }
+};
+
+// 현재 사용 중인 플랜 + 윈도우 조합
+struct FftSetup {
+    FftPlan* plan = nullptr;
+    const FftWindow* window = nullptr;   // 일반 FFT용 (길이 size)
+    const FftWindow* pfb = nullptr;      // PFB 채널라이저용 (길이 taps * size)
+
+    int size() const { return plan ? plan->size : 0; }
+};
+
+class FftPlanCache {
+public:
+    explicit FftPlanCache(int pfb_taps = 1, double pfb_bin_width = 1.0)
+        : pfb_taps_(pfb_taps), pfb_bin_width_(pfb_bin_width) {}
+
+    // 없으면 생성, 있으면 캐시된 것 반환 (재플래닝 없음)
+    FftSetup get(int size, WindowType type) {
+        FftSetup setup;
+
+        auto plan_it = plans_.find(size);
+        if (plan_it == plans_.end()) {
+            plan_it = plans_.emplace(size, std::unique_ptr<FftPlan>(new FftPlan(size))).first;
+        }
+        setup.plan = plan_it->second.get();
+
+        auto key = std::make_pair(size, (int)type);
+        auto window_it = windows_.find(key);
+        if (window_it == windows_.end()) {
+            window_it = windows_.emplace(key, std::unique_ptr<FftWindow>(new FftWindow(size, type))).first;
+        }
+        setup.window = window_it->second.get();
+
+        if (pfb_taps_ > 1) {
+            auto pfb_it = pfb_filters_.find(key);
+            if (pfb_it == pfb_filters_.end()) {
+                pfb_it = pfb_filters_.emplace(key, std::unique_ptr<FftWindow>(new FftWindow(size, type, pfb_taps_, pfb_bin_width_))).first;
+            }
+            setup.pfb = pfb_it->second.get();
+        }
+
+        return setup;
+    }
+
+    // min_size ~ max_size (2의 거듭제곱) 전체 플랜과 윈도우를 미리 생성
+    void prewarm(int min_size, int max_size) {
+        for (int size = min_size; size <= max_size; size *= 2) {
+            for (int type = 0; type < WINDOW_TYPE_COUNT; type++) {
+                get(size, (WindowType)type);
+            }
+        }
+    }
+
+    size_t num_plans() const { return plans_.size(); }
+    size_t num_windows() const { return windows_.size() + pfb_filters_.size(); }
+    int pfb_taps() const { return pfb_taps_; }
+
+private:
+    int pfb_taps_;
+    double pfb_bin_width_;
+    std::map<int, std::unique_ptr<FftPlan>> plans_;
+    std::map<std::pair<int, int>, std::unique_ptr<FftWindow>> windows_;
+    std::map<std::pair<int, int>, std::unique_ptr<FftWindow>> pfb_filters_;
+};
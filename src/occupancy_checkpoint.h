@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include "occupancy_stats.h"
+
+// ==================== 점유율 체크포인트 백그라운드 writer ====================
+// 체크포인트는 수십 MB(빈별 히스토그램 + 에포크 링 버퍼)라 스윕 스레드에서 직접 쓰면
+// 디스크 속도에 따라 수백 ms 이상 스윕이 멈춘다. 스윕 스레드는 미리 할당한 스냅샷으로
+// 메모리 복사만 하고, 파일 쓰기(임시 파일 + rename)는 전용 스레드가 한다.
+//  - prepare(): 구성(빈 수)이 바뀔 때 스냅샷 버퍼 할당 + 스레드 시작 (진행 중인 쓰기는 먼저 완료)
+//  - submit():  스냅샷 복사 후 쓰기 요청 — 할당 없음. 이전 쓰기가 아직 진행 중이면 건너뜀
+//  - wait():    진행 중인 쓰기 완료 대기 (구성 전환/종료 시)
+
+class OccupancyCheckpointWriter {
+public:
+    ~OccupancyCheckpointWriter() { stop(); }
+
+    void prepare(const OccupancyStats& stats) {
+        wait();
+        snapshot_ = stats;   // 같은 크기 구성이면 이후 복사는 재할당 없음
+        if (!thread_.joinable()) {
+            stopping_ = false;
+            thread_ = std::thread(&OccupancyCheckpointWriter::run, this);
+        }
+    }
+
+    // stats를 스냅샷으로 복사하고 path에 쓰기 요청. 이전 쓰기가 진행 중이면 false
+    bool submit(const OccupancyStats& stats, const char* path) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (pending_ || !thread_.joinable()) return false;
+        lock.unlock();
+
+        snapshot_ = stats;   // 쓰기 스레드는 pending_ 전까지 스냅샷을 만지지 않음
+        snprintf(path_, sizeof(path_), "%s", path);
+
+        lock.lock();
+        pending_ = true;
+        lock.unlock();
+        cv_.notify_all();
+        return true;
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !pending_; });
+    }
+
+    // 남은 쓰기를 마치고 스레드 종료
+    void stop() {
+        if (!thread_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    bool busy() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_;
+    }
+
+    uint64_t written() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return written_;
+    }
+
+    uint64_t failed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return failed_;
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            cv_.wait(lock, [this] { return pending_ || stopping_; });
+            if (!pending_) return;   // 종료 요청 + 남은 쓰기 없음
+
+            lock.unlock();
+            bool ok = snapshot_.save_checkpoint(path_);
+            if (!ok) fprintf(stderr, "⚠ 점유율 체크포인트 저장 실패: %s\n", path_);
+            lock.lock();
+
+            if (ok) {
+                written_++;
+            } else {
+                failed_++;
+            }
+            pending_ = false;
+            cv_.notify_all();
+        }
+    }
+
+    OccupancyStats snapshot_;
+    char path_[512] = {};
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool pending_ = false;
+    bool stopping_ = false;
+    uint64_t written_ = 0;
+    uint64_t failed_ = 0;
+};
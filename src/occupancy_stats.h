@@ -0,0 +1,544 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ==================== 장기 점유율 통계 엔진 ====================
+// 스윕마다 스티칭된 스펙트럼을 받아 빈(bin)별 통계를 누적한다.
+//  - 전체 기간: 최소/최대, 선형 파워 평균, 임계값 초과 비율(duty cycle),
+//               고정 버킷 히스토그램(백분위 스케치)
+//  - 시간 창: epoch_seconds마다 열(column) 단위로 요약한 에포크를 링 버퍼에 보관
+//    (열 = 인접 빈 묶음, 메모리를 FFT 크기와 무관하게 유지)
+// 원시 스윕을 저장하지 않고 수 시간~수 일의 점유율 보고가 가능하다.
+// 스윕 스레드 전용 (내부 동기화 없음). 워밍업 이후 update()는 힙 할당을 하지 않는다.
+
+struct OccupancyConfig {
+    float duty_threshold_db = -60.0f;   // 이 레벨 초과 시 "점유"
+    float hist_min_db = -140.0f;        // 히스토그램 범위 (밖의 값은 양 끝 버킷)
+    float hist_max_db = 10.0f;
+    int hist_buckets = 50;              // 3 dB 버킷
+    double epoch_seconds = 600.0;       // 에포크 길이 (10분)
+    int max_epochs = 144;               // 보관 에포크 수 (10분 × 144 = 24시간)
+    int epoch_columns = 4096;           // 에포크 기록의 주파수 열 수
+};
+
+// 질의 결과 요약
+struct OccupancySummary {
+    float min_db;
+    float max_db;
+    float mean_db;       // 선형 파워 평균의 dB
+    float duty;          // 0.0 ~ 1.0
+    uint64_t samples;    // 반영된 (빈 × 스윕) 수
+};
+
+class OccupancyStats {
+public:
+    void configure(size_t num_bins, double start_hz, double hz_per_bin, const OccupancyConfig& config) {
+        config_ = config;
+        if (config_.epoch_columns > (int)num_bins) config_.epoch_columns = (int)num_bins;
+        if (config_.epoch_columns < 1) config_.epoch_columns = 1;
+
+        num_bins_ = num_bins;
+        start_hz_ = start_hz;
+        hz_per_bin_ = hz_per_bin;
+        bucket_width_db_ = (config_.hist_max_db - config_.hist_min_db) / config_.hist_buckets;
+
+        min_db_.assign(num_bins, INFINITY);
+        max_db_.assign(num_bins, -INFINITY);
+        lin_sum_.assign(num_bins, 0.0);
+        count_.assign(num_bins, 0);
+        above_.assign(num_bins, 0);
+        hist_.assign(num_bins * config_.hist_buckets, 0);
+        lin_scratch_.assign(num_bins, 0.0f);
+        merged_scratch_.assign(config_.hist_buckets, 0);
+
+        column_of_bin_.resize(num_bins);
+        for (size_t i = 0; i < num_bins; i++) {
+            column_of_bin_[i] = (uint32_t)(i * config_.epoch_columns / num_bins);
+        }
+
+        size_t columns = config_.epoch_columns;
+        col_min_.assign(columns, INFINITY);
+        col_max_.assign(columns, -INFINITY);
+        col_lin_sum_.assign(columns, 0.0);
+        col_above_.assign(columns, 0);
+        col_count_.assign(columns, 0);
+
+        size_t epoch_cells = (size_t)config_.max_epochs * columns;
+        epoch_min_db_.assign(epoch_cells, NAN);
+        epoch_max_db_.assign(epoch_cells, NAN);
+        epoch_mean_db_.assign(epoch_cells, NAN);
+        epoch_duty_.assign(epoch_cells, NAN);
+        epoch_t0_.assign(config_.max_epochs, 0.0);
+        epoch_t1_.assign(config_.max_epochs, 0.0);
+        epoch_head_ = 0;
+        epoch_count_ = 0;
+
+        sweeps_ = 0;
+        first_time_ = 0.0;
+        last_time_ = 0.0;
+        epoch_start_ = 0.0;
+    }
+
+    // 한 스윕 반영: spectrum[first, last] 중 measured[i] != 0인 빈만 측정값으로 취급
+    // (measured = nullptr이면 범위 전체, timestamp: 유닉스 초)
+    // 스티칭 배열은 FFT 빈보다 촘촘해 사이사이 기록되지 않은 빈이 있으므로 마스크가 필요
+    void update(const float* spectrum, const uint8_t* measured, size_t first, size_t last, double timestamp) {
+        if (num_bins_ == 0 || first > last || last >= num_bins_) return;
+
+        if (sweeps_ == 0) {
+            first_time_ = timestamp;
+            epoch_start_ = timestamp;
+        } else if (timestamp - epoch_start_ >= config_.epoch_seconds) {
+            close_epoch(timestamp);
+        }
+        sweeps_++;
+        last_time_ = timestamp;
+
+        size_t n = last - first + 1;
+        const float* x = spectrum + first;
+        const uint8_t* m = measured ? measured + first : nullptr;
+
+        // dB → 선형 파워
+        float* lin = lin_scratch_.data();
+        for (size_t i = 0; i < n; i++) {
+            lin[i] = expf(x[i] * 0.230258509f);  // 10^(dB/10)
+        }
+
+        update_bins(x, lin, m, first, n);
+        update_histogram(x, m, first, n);
+        update_columns(x, lin, m, first, n);
+    }
+
+    // 전체 기간, 주파수 범위 [f_lo, f_hi] 요약
+    OccupancySummary query(double f_lo_hz, double f_hi_hz) const {
+        OccupancySummary summary = empty_summary();
+        size_t lo, hi;
+        if (!bin_range(f_lo_hz, f_hi_hz, lo, hi)) return summary;
+
+        double lin_sum = 0.0;
+        uint64_t above = 0;
+        for (size_t i = lo; i <= hi; i++) {
+            if (count_[i] == 0) continue;
+            summary.min_db = fminf(summary.min_db, min_db_[i]);
+            summary.max_db = fmaxf(summary.max_db, max_db_[i]);
+            lin_sum += lin_sum_[i];
+            above += above_[i];
+            summary.samples += count_[i];
+        }
+        finish_summary(summary, lin_sum, above);
+        return summary;
+    }
+
+    // 전체 기간, 주파수 범위의 p 백분위 (0~100, 히스토그램 버킷 내 선형 보간)
+    float percentile(double f_lo_hz, double f_hi_hz, float p) const {
+        size_t lo, hi;
+        if (!bin_range(f_lo_hz, f_hi_hz, lo, hi)) return NAN;
+
+        int buckets = config_.hist_buckets;
+        uint64_t* merged = merged_scratch_.data();
+        std::fill(merged, merged + buckets, 0);
+        uint64_t total = 0;
+        for (size_t i = lo; i <= hi; i++) {
+            const uint32_t* h = hist_.data() + i * buckets;
+            for (int b = 0; b < buckets; b++) {
+                merged[b] += h[b];
+                total += h[b];
+            }
+        }
+        if (total == 0) return NAN;
+
+        double target = fmin(fmax(p, 0.0f), 100.0f) / 100.0 * total;
+        uint64_t cumulative = 0;
+        for (int b = 0; b < buckets; b++) {
+            if (merged[b] > 0 && cumulative + merged[b] >= target) {
+                double frac = (target - cumulative) / merged[b];
+                return config_.hist_min_db + bucket_width_db_ * (float)(b + frac);
+            }
+            cumulative += merged[b];
+        }
+        return config_.hist_max_db;
+    }
+
+    // 시간 창 [t_lo, t_hi] (유닉스 초) × 주파수 범위 요약 (에포크 해상도, 진행 중인 에포크 포함)
+    OccupancySummary query_window(double f_lo_hz, double f_hi_hz, double t_lo, double t_hi) const {
+        OccupancySummary summary = empty_summary();
+        size_t lo, hi;
+        if (!bin_range(f_lo_hz, f_hi_hz, lo, hi)) return summary;
+        size_t col_lo = column_of_bin_[lo];
+        size_t col_hi = column_of_bin_[hi];
+        size_t columns = config_.epoch_columns;
+
+        double lin_sum = 0.0;
+        double duty_sum = 0.0;
+        uint64_t cells = 0;
+
+        // 닫힌 에포크 (열별 평균/듀티는 동일 가중)
+        for (int e = 0; e < epoch_count_; e++) {
+            if (epoch_t1_[e] < t_lo || epoch_t0_[e] > t_hi) continue;
+            for (size_t c = col_lo; c <= col_hi; c++) {
+                size_t cell = (size_t)e * columns + c;
+                if (std::isnan(epoch_mean_db_[cell])) continue;
+                summary.min_db = fminf(summary.min_db, epoch_min_db_[cell]);
+                summary.max_db = fmaxf(summary.max_db, epoch_max_db_[cell]);
+                lin_sum += pow(10.0, epoch_mean_db_[cell] / 10.0);
+                duty_sum += epoch_duty_[cell];
+                cells++;
+            }
+        }
+
+        // 진행 중인 에포크
+        if (sweeps_ > 0 && last_time_ >= t_lo && epoch_start_ <= t_hi) {
+            for (size_t c = col_lo; c <= col_hi; c++) {
+                if (col_count_[c] == 0) continue;
+                summary.min_db = fminf(summary.min_db, col_min_[c]);
+                summary.max_db = fmaxf(summary.max_db, col_max_[c]);
+                lin_sum += col_lin_sum_[c] / col_count_[c];
+                duty_sum += (double)col_above_[c] / col_count_[c];
+                cells++;
+            }
+        }
+
+        summary.samples = cells;
+        if (cells > 0) {
+            summary.mean_db = (float)(10.0 * log10(lin_sum / cells));
+            summary.duty = (float)(duty_sum / cells);
+        } else {
+            summary.min_db = NAN;
+            summary.max_db = NAN;
+        }
+        return summary;
+    }
+
+    // ========== 체크포인트 ==========
+    // 임시 파일에 쓴 뒤 rename → 쓰는 도중 종료돼도 이전 체크포인트가 유지됨
+    bool save_checkpoint(const char* path) const {
+        char tmp_path[512];
+        snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+        FILE* f = fopen(tmp_path, "wb");
+        if (!f) return false;
+
+        CheckpointHeader header = make_header();
+        bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+        ok = ok && write_array(f, min_db_) && write_array(f, max_db_) &&
+             write_array(f, lin_sum_) && write_array(f, count_) &&
+             write_array(f, above_) && write_array(f, hist_) &&
+             write_array(f, col_min_) && write_array(f, col_max_) &&
+             write_array(f, col_lin_sum_) && write_array(f, col_above_) &&
+             write_array(f, col_count_) &&
+             write_array(f, epoch_min_db_) && write_array(f, epoch_max_db_) &&
+             write_array(f, epoch_mean_db_) && write_array(f, epoch_duty_) &&
+             write_array(f, epoch_t0_) && write_array(f, epoch_t1_);
+        ok = (fclose(f) == 0) && ok;
+
+        if (!ok || rename(tmp_path, path) != 0) {
+            remove(tmp_path);
+            return false;
+        }
+        return true;
+    }
+
+    // 현재 구성(빈 수, 주파수 축, 히스토그램/에포크 설정)과 일치하는 체크포인트만 복원
+    // 에포크 링 위치가 범위를 벗어난 (손상된) 체크포인트는 거부 → 이후 링 버퍼 인덱스가 항상 유효
+    bool load_checkpoint(const char* path) {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+
+        CheckpointHeader header;
+        CheckpointHeader expected = make_header();
+        bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+                  memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0 &&
+                  header.version == expected.version &&
+                  header.num_bins == expected.num_bins &&
+                  header.hist_buckets == expected.hist_buckets &&
+                  header.epoch_columns == expected.epoch_columns &&
+                  header.max_epochs == expected.max_epochs &&
+                  header.start_hz == expected.start_hz &&
+                  header.hz_per_bin == expected.hz_per_bin &&
+                  header.duty_threshold_db == expected.duty_threshold_db &&
+                  header.hist_min_db == expected.hist_min_db &&
+                  header.hist_max_db == expected.hist_max_db &&
+                  valid_epoch_ring(header);
+        ok = ok && read_array(f, min_db_) && read_array(f, max_db_) &&
+             read_array(f, lin_sum_) && read_array(f, count_) &&
+             read_array(f, above_) && read_array(f, hist_) &&
+             read_array(f, col_min_) && read_array(f, col_max_) &&
+             read_array(f, col_lin_sum_) && read_array(f, col_above_) &&
+             read_array(f, col_count_) &&
+             read_array(f, epoch_min_db_) && read_array(f, epoch_max_db_) &&
+             read_array(f, epoch_mean_db_) && read_array(f, epoch_duty_) &&
+             read_array(f, epoch_t0_) && read_array(f, epoch_t1_);
+        fclose(f);
+
+        if (!ok) {
+            // 일부만 읽혔을 수 있으므로 초기 상태로 되돌림
+            OccupancyConfig config = config_;
+            configure(num_bins_, start_hz_, hz_per_bin_, config);
+            return false;
+        }
+
+        sweeps_ = header.sweeps;
+        first_time_ = header.first_time;
+        last_time_ = header.last_time;
+        epoch_start_ = header.epoch_start;
+        epoch_head_ = header.epoch_head;
+        epoch_count_ = header.epoch_count;
+        return true;
+    }
+
+    uint64_t sweeps() const { return sweeps_; }
+    double first_time() const { return first_time_; }
+    double last_time() const { return last_time_; }
+    int epoch_count() const { return epoch_count_; }
+    const OccupancyConfig& config() const { return config_; }
+
+private:
+    struct CheckpointHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t hist_buckets;
+        uint64_t num_bins;
+        uint32_t epoch_columns;
+        uint32_t max_epochs;
+        double start_hz;
+        double hz_per_bin;
+        float duty_threshold_db;
+        float hist_min_db;
+        float hist_max_db;
+        float reserved;
+        uint64_t sweeps;
+        double first_time;
+        double last_time;
+        double epoch_start;
+        int32_t epoch_head;
+        int32_t epoch_count;
+    };
+
+    CheckpointHeader make_header() const {
+        CheckpointHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "BRFOCC\0\0", sizeof(header.magic));
+        header.version = 1;
+        header.hist_buckets = config_.hist_buckets;
+        header.num_bins = num_bins_;
+        header.epoch_columns = config_.epoch_columns;
+        header.max_epochs = config_.max_epochs;
+        header.start_hz = start_hz_;
+        header.hz_per_bin = hz_per_bin_;
+        header.duty_threshold_db = config_.duty_threshold_db;
+        header.hist_min_db = config_.hist_min_db;
+        header.hist_max_db = config_.hist_max_db;
+        header.sweeps = sweeps_;
+        header.first_time = first_time_;
+        header.last_time = last_time_;
+        header.epoch_start = epoch_start_;
+        header.epoch_head = epoch_head_;
+        header.epoch_count = epoch_count_;
+        return header;
+    }
+
+    // epoch_head ∈ [0, max_epochs), epoch_count ∈ [0, max_epochs]
+    // 링이 차기 전(epoch_count < max_epochs)에는 close_epoch가 0번부터 채우므로 head == count
+    bool valid_epoch_ring(const CheckpointHeader& header) const {
+        int32_t max_epochs = config_.max_epochs;
+        if (header.epoch_head < 0 || header.epoch_head >= max_epochs) return false;
+        if (header.epoch_count < 0 || header.epoch_count > max_epochs) return false;
+        return header.epoch_count == max_epochs || header.epoch_head == header.epoch_count;
+    }
+
+    template <typename T>
+    static bool write_array(FILE* f, const std::vector<T>& v) {
+        return fwrite(v.data(), sizeof(T), v.size(), f) == v.size();
+    }
+
+    template <typename T>
+    static bool read_array(FILE* f, std::vector<T>& v) {
+        return fread(v.data(), sizeof(T), v.size(), f) == v.size();
+    }
+
+    static OccupancySummary empty_summary() {
+        OccupancySummary summary;
+        summary.min_db = INFINITY;
+        summary.max_db = -INFINITY;
+        summary.mean_db = NAN;
+        summary.duty = NAN;
+        summary.samples = 0;
+        return summary;
+    }
+
+    static void finish_summary(OccupancySummary& summary, double lin_sum, uint64_t above) {
+        if (summary.samples == 0) {
+            summary.min_db = NAN;
+            summary.max_db = NAN;
+            return;
+        }
+        summary.mean_db = (float)(10.0 * log10(lin_sum / summary.samples));
+        summary.duty = (float)((double)above / summary.samples);
+    }
+
+    bool bin_range(double f_lo_hz, double f_hi_hz, size_t& lo, size_t& hi) const {
+        if (num_bins_ == 0 || f_hi_hz < f_lo_hz) return false;
+        double lo_index = floor((f_lo_hz - start_hz_) / hz_per_bin_);
+        double hi_index = floor((f_hi_hz - start_hz_) / hz_per_bin_);
+        if (hi_index < 0.0 || lo_index >= (double)num_bins_) return false;
+        lo = lo_index < 0.0 ? 0 : (size_t)lo_index;
+        hi = hi_index >= (double)num_bins_ ? num_bins_ - 1 : (size_t)hi_index;
+        return true;
+    }
+
+    // 빈별 최소/최대/선형 합/카운트/임계값 초과 (AVX2: 8빈씩, 측정되지 않은 빈은 마스크로 제외)
+    void update_bins(const float* x, const float* lin, const uint8_t* measured, size_t first, size_t n) {
+        float* mn = min_db_.data() + first;
+        float* mx = max_db_.data() + first;
+        double* sum = lin_sum_.data() + first;
+        uint32_t* cnt = count_.data() + first;
+        uint32_t* above = above_.data() + first;
+        const float threshold = config_.duty_threshold_db;
+
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256 thr = _mm256_set1_ps(threshold);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i all = _mm256_set1_epi32(-1);
+        const __m256i zero = _mm256_setzero_si256();
+        for (; i + 8 <= n; i += 8) {
+            __m256i mask = all;
+            if (measured) {
+                __m256i flags = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(measured + i)));
+                mask = _mm256_xor_si256(_mm256_cmpeq_epi32(flags, zero), all);
+            }
+            __m256 mask_ps = _mm256_castsi256_ps(mask);
+
+            __m256 v = _mm256_loadu_ps(x + i);
+            __m256 old_mn = _mm256_loadu_ps(mn + i);
+            __m256 old_mx = _mm256_loadu_ps(mx + i);
+            _mm256_storeu_ps(mn + i, _mm256_blendv_ps(old_mn, _mm256_min_ps(old_mn, v), mask_ps));
+            _mm256_storeu_ps(mx + i, _mm256_blendv_ps(old_mx, _mm256_max_ps(old_mx, v), mask_ps));
+
+            __m256 l = _mm256_and_ps(_mm256_loadu_ps(lin + i), mask_ps);
+            __m256d l_lo = _mm256_cvtps_pd(_mm256_castps256_ps128(l));
+            __m256d l_hi = _mm256_cvtps_pd(_mm256_extractf128_ps(l, 1));
+            _mm256_storeu_pd(sum + i, _mm256_add_pd(_mm256_loadu_pd(sum + i), l_lo));
+            _mm256_storeu_pd(sum + i + 4, _mm256_add_pd(_mm256_loadu_pd(sum + i + 4), l_hi));
+
+            __m256i c = _mm256_loadu_si256((const __m256i*)(cnt + i));
+            _mm256_storeu_si256((__m256i*)(cnt + i), _mm256_add_epi32(c, _mm256_and_si256(mask, one)));
+
+            __m256i hit = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(v, thr, _CMP_GT_OQ)),
+                                           _mm256_and_si256(mask, one));
+            __m256i a = _mm256_loadu_si256((const __m256i*)(above + i));
+            _mm256_storeu_si256((__m256i*)(above + i), _mm256_add_epi32(a, hit));
+        }
+#endif
+        for (; i < n; i++) {
+            if (measured && !measured[i]) continue;
+            mn[i] = fminf(mn[i], x[i]);
+            mx[i] = fmaxf(mx[i], x[i]);
+            sum[i] += lin[i];
+            cnt[i]++;
+            above[i] += x[i] > threshold ? 1 : 0;
+        }
+    }
+
+    void update_histogram(const float* x, const uint8_t* measured, size_t first, size_t n) {
+        const int buckets = config_.hist_buckets;
+        const float inv_width = 1.0f / bucket_width_db_;
+        uint32_t* h = hist_.data() + first * buckets;
+        for (size_t i = 0; i < n; i++) {
+            if (measured && !measured[i]) continue;
+            int b = (int)((x[i] - config_.hist_min_db) * inv_width);
+            if (b < 0) b = 0;
+            if (b >= buckets) b = buckets - 1;
+            h[i * buckets + b]++;
+        }
+    }
+
+    void update_columns(const float* x, const float* lin, const uint8_t* measured, size_t first, size_t n) {
+        const float threshold = config_.duty_threshold_db;
+        for (size_t i = 0; i < n; i++) {
+            if (measured && !measured[i]) continue;
+            uint32_t c = column_of_bin_[first + i];
+            col_min_[c] = fminf(col_min_[c], x[i]);
+            col_max_[c] = fmaxf(col_max_[c], x[i]);
+            col_lin_sum_[c] += lin[i];
+            col_above_[c] += x[i] > threshold ? 1 : 0;
+            col_count_[c]++;
+        }
+    }
+
+    // 진행 중인 에포크를 링 버퍼에 기록하고 열 누적값 초기화
+    void close_epoch(double now) {
+        size_t columns = config_.epoch_columns;
+        size_t base = (size_t)epoch_head_ * columns;
+        for (size_t c = 0; c < columns; c++) {
+            if (col_count_[c] == 0) {
+                epoch_min_db_[base + c] = NAN;
+                epoch_max_db_[base + c] = NAN;
+                epoch_mean_db_[base + c] = NAN;
+                epoch_duty_[base + c] = NAN;
+            } else {
+                epoch_min_db_[base + c] = col_min_[c];
+                epoch_max_db_[base + c] = col_max_[c];
+                epoch_mean_db_[base + c] = (float)(10.0 * log10(col_lin_sum_[c] / col_count_[c]));
+                epoch_duty_[base + c] = (float)col_above_[c] / col_count_[c];
+            }
+            col_min_[c] = INFINITY;
+            col_max_[c] = -INFINITY;
+            col_lin_sum_[c] = 0.0;
+            col_above_[c] = 0;
+            col_count_[c] = 0;
+        }
+        epoch_t0_[epoch_head_] = epoch_start_;
+        epoch_t1_[epoch_head_] = last_time_;
+
+        epoch_head_ = (epoch_head_ + 1) % config_.max_epochs;
+        if (epoch_count_ < config_.max_epochs) epoch_count_++;
+        epoch_start_ = now;
+    }
+
+    OccupancyConfig config_;
+    size_t num_bins_ = 0;
+    double start_hz_ = 0.0;
+    double hz_per_bin_ = 1.0;
+    float bucket_width_db_ = 1.0f;
+
+    // 전체 기간 (빈별)
+    std::vector<float> min_db_;
+    std::vector<float> max_db_;
+    std::vector<double> lin_sum_;
+    std::vector<uint32_t> count_;
+    std::vector<uint32_t> above_;
+    std::vector<uint32_t> hist_;          // num_bins × hist_buckets
+    std::vector<float> lin_scratch_;
+    mutable std::vector<uint64_t> merged_scratch_;   // percentile() 작업 버퍼
+
+    // 진행 중인 에포크 (열별)
+    std::vector<uint32_t> column_of_bin_;
+    std::vector<float> col_min_;
+    std::vector<float> col_max_;
+    std::vector<double> col_lin_sum_;
+    std::vector<uint32_t> col_above_;
+    std::vector<uint32_t> col_count_;
+
+    // 닫힌 에포크 링 버퍼 (max_epochs × epoch_columns)
+    std::vector<float> epoch_min_db_;
+    std::vector<float> epoch_max_db_;
+    std::vector<float> epoch_mean_db_;
+    std::vector<float> epoch_duty_;
+    std::vector<double> epoch_t0_;
+    std::vector<double> epoch_t1_;
+    int epoch_head_ = 0;
+    int epoch_count_ = 0;
+
+    uint64_t sweeps_ = 0;
+    double first_time_ = 0.0;
+    double last_time_ = 0.0;
+    double epoch_start_ = 0.0;
+};
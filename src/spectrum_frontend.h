@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include "fft_plan_cache.h"
+
+// ==================== 스펙트럼 프런트엔드 ====================
+// IQ 블록 하나 → dBFS 스펙트럼 (윈도우 FFT 또는 PFB/WOLA 채널라이저) 및 DC 빈 처리.
+// 전역 상태와 무관하므로 하드웨어 없이 벤치마크/테스트에서 그대로 사용할 수 있다.
+
+enum FrontEnd {
+    FRONTEND_FFT = 0,   // 윈도우 FFT (캡처 N 샘플)
+    FRONTEND_PFB,       // PFB/WOLA 채널라이저 (캡처 taps * N 샘플)
+    FRONTEND_COUNT
+};
+
+// DC 빈(LO 누설 스파이크) 처리
+enum DcMode {
+    DC_KEEP = 0,        // 그대로
+    DC_INTERPOLATE,     // 양옆 빈 사이 선형 보간
+    DC_FLOOR,           // 양옆 빈 중 낮은 값으로 채움
+    DC_MODE_COUNT
+};
+
+inline const char* frontend_name(int frontend) {
+    return frontend == FRONTEND_PFB ? "PFB" : "FFT";
+}
+
+inline const char* dc_mode_name(int mode) {
+    switch (mode) {
+        case DC_KEEP:        return "keep";
+        case DC_INTERPOLATE: return "interp";
+        case DC_FLOOR:       return "floor";
+        default:             return "?";
+    }
+}
+
+// DC 처리 폭 (중심 ± notch_hz, 최소 1빈)
+inline int dc_half_width_bins(double notch_hz, int fft_size, double sample_rate) {
+    int half_width = (int)ceil(notch_hz * fft_size / sample_rate);
+    return half_width < 1 ? 1 : half_width;
+}
+
+// DC 주변 빈 처리 (fft_result는 shift된 순서, 중심 = fft_size/2)
+inline void apply_dc_handling(float* fft_result, int fft_size, int mode, int half_width) {
+    if (mode == DC_KEEP) return;
+
+    int lo = fft_size / 2 - half_width - 1;
+    int hi = fft_size / 2 + half_width + 1;
+    if (lo < 0 || hi >= fft_size) return;
+
+    float left = fft_result[lo];
+    float right = fft_result[hi];
+    for (int i = lo + 1; i < hi; i++) {
+        if (mode == DC_INTERPOLATE) {
+            fft_result[i] = left + (right - left) * (i - lo) / (float)(hi - lo);
+        } else {
+            fft_result[i] = fminf(left, right);
+        }
+    }
+}
+
+// fft_result: fft_size개의 dBFS 값 (DC가 중앙에 오도록 shift된 순서로 기록)
+// iq_data: FFT 프런트엔드는 fft_size, PFB는 fft.pfb->taps * fft_size 샘플 (SC16 Q11)
+inline void compute_spectrum(const FftSetup& fft, bool use_pfb, const int16_t* iq_data, float* fft_result) {
+    const FftPlan& plan = *fft.plan;
+    const int fft_size = plan.size;
+    const FftWindow& window = use_pfb ? *fft.pfb : *fft.window;
+
+    if (use_pfb) {
+        // WOLA: 프로토타입 필터를 곱한 뒤 taps개 구간을 fft_size 길이로 접어 더함
+        // → 빈 응답이 평탄하고 누설이 적어 캡처 대역 가장자리까지 사용 가능
+        const int taps = window.taps;
+        for (int i = 0; i < fft_size; i++) {
+            float re = 0.0f;
+            float im = 0.0f;
+            for (int t = 0; t < taps; t++) {
+                int n = t * fft_size + i;
+                float h = window.coeffs[n];
+                re += iq_data[2 * n] * h;
+                im += iq_data[2 * n + 1] * h;
+            }
+            plan.in[i][0] = re / 2048.0f;  // Q11 → 정규화
+            plan.in[i][1] = im / 2048.0f;
+        }
+    } else {
+        // IQ 데이터를 복소수로 변환하고 윈도우 적용
+        for (int i = 0; i < fft_size; i++) {
+            float i_val = iq_data[2 * i] / 2048.0f;  // Q11 → 정규화
+            float q_val = iq_data[2 * i + 1] / 2048.0f;
+            plan.in[i][0] = i_val * window.coeffs[i];
+            plan.in[i][1] = q_val * window.coeffs[i];
+        }
+    }
+
+    // FFT 수행
+    fftw_execute(plan.plan);
+
+    // 파워 스펙트럼 계산 (dBFS) + FFT shift (DC를 중앙으로)
+    int half = fft_size / 2;
+    float norm = 1.0f / ((float)fft_size * fft_size);
+    for (int i = 0; i < fft_size; i++) {
+        float real = plan.out[i][0];
+        float imag = plan.out[i][1];
+        float power = (real * real + imag * imag) * norm;
+
+        // dBFS로 변환 (Full Scale 기준)
+        float db = 10.0f * log10f(power + 1e-20f);
+
+        // 윈도우 손실 보정
+        db -= window.correction;
+
+        fft_result[(i + half) % fft_size] = db;
+    }
+}
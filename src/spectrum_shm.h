@@ -0,0 +1,402 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ==================== 공유 메모리 스펙트럼 게시 ====================
+// 스윕이 끝날 때마다 스티칭된 스펙트럼과 스윕 메타데이터를 POSIX 공유 메모리에 게시한다.
+// 같은 호스트의 다른 프로세스(기록기, 검출기, 익스포터)는 mmap 후 복사 없이 읽을 수 있다.
+//
+// 레이아웃 (버전 2):
+//   [SpectrumShmHeader (4 KiB)] [슬롯 0] [슬롯 1] ... [슬롯 slot_count-1]
+//   슬롯 = [SpectrumSlotMeta][float bins[max_bins]][uint8_t measured[max_bins]], slot_stride 바이트 간격
+//   measured[i] != 0 인 빈만 이번 스윕의 측정값 (스티칭 배열이 FFT 빈보다 촘촘해 사이 빈은 채움값)
+//
+// 동시성: 단일 writer, 다수 reader, 잠금 없음 (슬롯별 seqlock)
+//  - writer: 게시 번호 n을 슬롯 n % slot_count에 기록
+//            seq를 홀수로 → 데이터 기록 → seq를 짝수로 → header.latest_sequence = n
+//  - reader: latest_sequence로 슬롯을 찾고, 읽기 전후 seq가 같은 짝수이면 일관된 스윕
+//    여러 슬롯을 돌려 쓰므로 reader는 slot_count - 1 스윕 동안 제자리에서 읽을 수 있음
+//  - writer는 reader를 기다리지 않으므로 스윕 스레드에 영향 없음
+//  - writer가 게시 도중 종료돼 seq가 홀수로 남은 슬롯은 다음 writer가 열 때 무효화
+//  - 살아 있는 writer가 있는 세그먼트에는 두 번째 writer가 붙지 않음 (open 실패, errno = EBUSY)
+//  - 레이아웃이 바뀌면 기존 세그먼트를 shm_unlink하고 새로 만듦: 크기를 바꾸지 않으므로
+//    옛 세그먼트를 매핑한 reader는 SIGBUS 없이 옛 내용을 보다가 다시 열면 새 세그먼트를 봄
+
+#define SPECTRUM_SHM_NAME     "/bladerf_spectrum"      // 기본 세그먼트 이름 (/dev/shm)
+#define SPECTRUM_SHM_MAGIC    0x314D485346524242ULL    // "BBRFSHM1"
+#define SPECTRUM_SHM_VERSION  2
+#define SPECTRUM_SHM_HEADER_SIZE 4096
+
+struct SpectrumShmHeader {
+    std::atomic<uint64_t> magic;            // 초기화 완료 후 마지막에 기록
+    uint32_t version;
+    uint32_t header_size;                   // 슬롯 영역 시작 오프셋
+    uint32_t slot_count;
+    uint32_t max_bins;                      // 슬롯당 최대 빈 수
+    uint64_t slot_stride;                   // 슬롯 간격 (바이트)
+    uint64_t total_size;                    // 세그먼트 전체 크기
+
+    // 스윕 범위 (표시 범위, 변하지 않음). 빈별 주파수 축은 슬롯 메타데이터에 있음
+    uint64_t start_freq_hz;
+    uint64_t end_freq_hz;
+    uint32_t sample_rate;
+    uint32_t writer_pid;
+
+    std::atomic<uint64_t> latest_sequence;  // 마지막 게시 번호 (0 = 아직 없음)
+    std::atomic<uint32_t> writer_active;    // writer 프로세스 동작 중이면 1
+};
+
+static_assert(sizeof(SpectrumShmHeader) <= SPECTRUM_SHM_HEADER_SIZE, "header exceeds reserved size");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory seqlock needs lock-free 64-bit atomics");
+
+// 스윕 하나의 메타데이터 (일반 복사 가능)
+struct SpectrumSweepInfo {
+    uint64_t sequence;           // 게시 번호
+    uint64_t sweep_count;
+    double timestamp;            // 스윕 완료 시각 (유닉스 초)
+
+    // 주파수 축: bins[i]의 주파수 = start_hz + i * hz_per_bin
+    double start_hz;
+    double hz_per_bin;
+    uint32_t num_bins;
+    uint32_t fft_size;
+    uint32_t window_type;
+    uint32_t frontend;
+
+    // 이번 스윕에서 측정된 빈의 최소/최대 인덱스 (사이의 개별 빈은 measured[]로 구분)
+    uint32_t first_bin;
+    uint32_t last_bin;
+    uint64_t checksum;           // bins/measured[0, num_bins)의 spectrum_shm_checksum()
+};
+
+// 슬롯 헤더 (bins 바로 앞에 위치)
+struct SpectrumSlotMeta {
+    std::atomic<uint64_t> seq;   // seqlock: 홀수 = 기록 중
+    SpectrumSweepInfo info;
+};
+
+inline size_t spectrum_shm_slot_stride(uint32_t max_bins) {
+    size_t bytes = sizeof(SpectrumSlotMeta) + (size_t)max_bins * (sizeof(float) + sizeof(uint8_t));
+    return (bytes + 63) & ~(size_t)63;
+}
+
+inline size_t spectrum_shm_total_size(uint32_t slot_count, uint32_t max_bins) {
+    return SPECTRUM_SHM_HEADER_SIZE + (size_t)slot_count * spectrum_shm_slot_stride(max_bins);
+}
+
+// 데이터 무결성 확인용 체크섬 (빈별 32비트 워드 + 측정 플래그 FNV-1a)
+inline uint64_t spectrum_shm_checksum(const float* bins, const uint8_t* measured, uint32_t num_bins) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint32_t i = 0; i < num_bins; i++) {
+        uint32_t word;
+        memcpy(&word, &bins[i], sizeof(word));
+        hash = (hash ^ word ^ ((uint64_t)measured[i] << 32)) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// ========== Writer (스윕 스레드) ==========
+class SpectrumShmWriter {
+public:
+    ~SpectrumShmWriter() { close(); }
+
+    // 세그먼트 생성/재사용. 같은 레이아웃이면 게시 번호를 이어감 (기존 reader 유지)
+    // 다른 writer 프로세스가 살아 있으면 false (errno = EBUSY)
+    bool open(const char* name, uint32_t slot_count, uint32_t max_bins,
+              uint64_t start_freq_hz, uint64_t end_freq_hz, uint32_t sample_rate) {
+        close();
+        size_t size = spectrum_shm_total_size(slot_count, max_bins);
+
+        int fd = shm_open(name, O_RDWR, 0);
+        if (fd >= 0) {
+            bool same_layout = false;
+            if (!inspect_existing(fd, slot_count, max_bins, size, same_layout)) {
+                ::close(fd);
+                errno = EBUSY;
+                return false;
+            }
+            if (!same_layout) {
+                // 기존 세그먼트 크기를 바꾸지 않고 이름만 떼어냄 (옛 매핑은 유효하게 남음)
+                ::close(fd);
+                fd = -1;
+                if (shm_unlink(name) != 0 && errno != ENOENT) return false;
+            }
+        }
+        if (fd < 0) {
+            fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+            if (fd < 0) return false;
+            if (ftruncate(fd, (off_t)size) != 0) {
+                int saved = errno;
+                ::close(fd);
+                shm_unlink(name);
+                errno = saved;
+                return false;
+            }
+        }
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) return false;
+
+        base_ = (uint8_t*)base;
+        size_ = size;
+        header_ = (SpectrumShmHeader*)base_;
+
+        bool same_layout = header_->magic.load(std::memory_order_acquire) == SPECTRUM_SHM_MAGIC &&
+                           header_->version == SPECTRUM_SHM_VERSION &&
+                           header_->slot_count == slot_count &&
+                           header_->max_bins == max_bins;
+        if (same_layout) {
+            sequence_ = header_->latest_sequence.load(std::memory_order_acquire);
+            // 이전 writer가 게시 도중 종료된 슬롯(seq 홀수)은 내용이 찢어져 있으므로
+            // 게시 번호를 지워 어떤 reader도 받아들이지 않게 하고 seq를 짝수로 되돌림
+            for (uint32_t i = 0; i < slot_count; i++) {
+                SpectrumSlotMeta* meta = (SpectrumSlotMeta*)slot_at(i);
+                uint64_t seq = meta->seq.load(std::memory_order_relaxed);
+                if (seq & 1) {
+                    meta->info.sequence = 0;
+                    meta->seq.store(seq + 1, std::memory_order_release);
+                }
+            }
+        } else {
+            // 새 레이아웃: 초기화가 끝날 때까지 magic = 0으로 reader 차단
+            header_->magic.store(0, std::memory_order_release);
+            memset(base_ + sizeof(std::atomic<uint64_t>), 0, size - sizeof(std::atomic<uint64_t>));
+            header_->version = SPECTRUM_SHM_VERSION;
+            header_->header_size = SPECTRUM_SHM_HEADER_SIZE;
+            header_->slot_count = slot_count;
+            header_->max_bins = max_bins;
+            header_->slot_stride = spectrum_shm_slot_stride(max_bins);
+            header_->total_size = size;
+            sequence_ = 0;
+        }
+        header_->start_freq_hz = start_freq_hz;
+        header_->end_freq_hz = end_freq_hz;
+        header_->sample_rate = sample_rate;
+        header_->writer_pid = (uint32_t)getpid();
+        header_->writer_active.store(1, std::memory_order_release);
+        header_->magic.store(SPECTRUM_SHM_MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    void close() {
+        if (!base_) return;
+        header_->writer_active.store(0, std::memory_order_release);
+        munmap(base_, size_);
+        base_ = nullptr;
+        header_ = nullptr;
+        size_ = 0;
+    }
+
+    bool is_open() const { return base_ != nullptr; }
+    uint64_t sequence() const { return sequence_; }
+
+    // 스윕 하나 게시. info의 sequence/num_bins/checksum은 여기서 채움
+    // measured: 빈별 측정 여부 (nullptr이면 전체 측정)
+    bool publish(const SpectrumSweepInfo& info, const float* bins, const uint8_t* measured, uint32_t num_bins) {
+        if (!base_ || num_bins > header_->max_bins) return false;
+
+        uint64_t sequence = sequence_ + 1;
+        uint8_t* slot = slot_at(sequence % header_->slot_count);
+        SpectrumSlotMeta* meta = (SpectrumSlotMeta*)slot;
+        float* slot_bins = (float*)(slot + sizeof(SpectrumSlotMeta));
+        uint8_t* slot_measured = (uint8_t*)(slot_bins + header_->max_bins);
+
+        // 어떤 상태에서 시작하든 기록 중에는 홀수, 완료 후에는 짝수
+        uint64_t writing = meta->seq.load(std::memory_order_relaxed) | 1;
+        meta->seq.store(writing, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        memcpy(slot_bins, bins, (size_t)num_bins * sizeof(float));
+        if (measured) {
+            memcpy(slot_measured, measured, num_bins);
+        } else {
+            memset(slot_measured, 1, num_bins);
+        }
+        meta->info = info;
+        meta->info.sequence = sequence;
+        meta->info.num_bins = num_bins;
+        meta->info.checksum = spectrum_shm_checksum(slot_bins, slot_measured, num_bins);
+
+        meta->seq.store(writing + 1, std::memory_order_release);
+        header_->latest_sequence.store(sequence, std::memory_order_release);
+        sequence_ = sequence;
+        return true;
+    }
+
+private:
+    uint8_t* slot_at(uint64_t index) const {
+        return base_ + header_->header_size + index * header_->slot_stride;
+    }
+
+    // 다른 프로세스가 쓰고 있을 수 있는 pid인지 (권한이 없어도 존재하면 살아 있음)
+    static bool process_alive(uint32_t pid) {
+        if (pid == 0) return false;
+        return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+    }
+
+    // 기존 세그먼트 헤더만 매핑해 검사. 살아 있는 writer가 있으면 false
+    // same_layout: 초기화가 끝났고 버전/슬롯 수/최대 빈 수/크기가 모두 같음
+    static bool inspect_existing(int fd, uint32_t slot_count, uint32_t max_bins, size_t size,
+                                 bool& same_layout) {
+        same_layout = false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SpectrumShmHeader)) return true;
+
+        void* p = mmap(nullptr, sizeof(SpectrumShmHeader), PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return true;
+        const SpectrumShmHeader* header = (const SpectrumShmHeader*)p;
+
+        bool initialized = header->magic.load(std::memory_order_acquire) == SPECTRUM_SHM_MAGIC &&
+                           header->version == SPECTRUM_SHM_VERSION;
+        bool live_writer = initialized && header->writer_active.load(std::memory_order_acquire) != 0 &&
+                           process_alive(header->writer_pid);
+        same_layout = initialized && header->slot_count == slot_count && header->max_bins == max_bins &&
+                      header->total_size == size && (size_t)st.st_size == size;
+        munmap(p, sizeof(SpectrumShmHeader));
+        return !live_writer;
+    }
+
+    uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    SpectrumShmHeader* header_ = nullptr;
+    uint64_t sequence_ = 0;
+};
+
+// ========== Reader 라이브러리 ==========
+// 제자리 읽기 (복사 없음): acquire_latest()로 뷰를 얻고, 처리 후 still_valid()로 확인
+//   SpectrumView view;
+//   if (reader.acquire_latest(view)) {
+//       ... view.bins / view.measured [0 .. view.info.num_bins) 사용 ...
+//       if (!reader.still_valid(view)) { /* 처리 중 덮어써짐 → 결과 폐기 */ }
+//   }
+// 복사 읽기: copy_latest()가 일관된 스윕을 호출자 버퍼에 복사 (재시도 포함)
+
+struct SpectrumView {
+    SpectrumSweepInfo info;      // 메타데이터 사본
+    const float* bins;           // 공유 메모리 안의 빈 데이터 (복사 아님)
+    const uint8_t* measured;     // 빈별 측정 여부 (공유 메모리, 0 = 채움값)
+    uint64_t seq_token;          // 읽기 시작 시점의 슬롯 seq
+    const SpectrumSlotMeta* slot;
+};
+
+class SpectrumShmReader {
+public:
+    ~SpectrumShmReader() { close(); }
+
+    bool open(const char* name) {
+        close();
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < SPECTRUM_SHM_HEADER_SIZE) {
+            ::close(fd);
+            return false;
+        }
+        void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) return false;
+
+        base_ = (const uint8_t*)base;
+        size_ = st.st_size;
+        header_ = (const SpectrumShmHeader*)base_;
+
+        if (header_->magic.load(std::memory_order_acquire) != SPECTRUM_SHM_MAGIC ||
+            header_->version != SPECTRUM_SHM_VERSION ||
+            header_->total_size > size_) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (!base_) return;
+        munmap((void*)base_, size_);
+        base_ = nullptr;
+        header_ = nullptr;
+        size_ = 0;
+    }
+
+    bool is_open() const { return base_ != nullptr; }
+    const SpectrumShmHeader* header() const { return header_; }
+
+    uint64_t latest_sequence() const {
+        return header_ ? header_->latest_sequence.load(std::memory_order_acquire) : 0;
+    }
+
+    bool writer_active() const {
+        return header_ && header_->writer_active.load(std::memory_order_acquire) != 0;
+    }
+
+    // 가장 최근 게시된 스윕의 제자리 뷰 (기록 중이면 max_retries까지 재시도)
+    bool acquire_latest(SpectrumView& view, int max_retries = 16) const {
+        if (!header_) return false;
+        for (int attempt = 0; attempt < max_retries; attempt++) {
+            uint64_t sequence = latest_sequence();
+            if (sequence == 0) return false;
+            if (acquire(sequence, view)) return true;
+        }
+        return false;
+    }
+
+    // 특정 게시 번호의 제자리 뷰 (이미 덮어써졌거나 기록 중이면 false)
+    bool acquire(uint64_t sequence, SpectrumView& view) const {
+        if (!header_ || sequence == 0) return false;
+        const SpectrumSlotMeta* slot = slot_meta(sequence % header_->slot_count);
+
+        uint64_t seq = slot->seq.load(std::memory_order_acquire);
+        if (seq & 1) return false;
+
+        view.info = slot->info;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->seq.load(std::memory_order_relaxed) != seq) return false;
+        if (view.info.sequence != sequence || view.info.num_bins > header_->max_bins) return false;
+
+        view.bins = (const float*)((const uint8_t*)slot + sizeof(SpectrumSlotMeta));
+        view.measured = (const uint8_t*)(view.bins + header_->max_bins);
+        view.seq_token = seq;
+        view.slot = slot;
+        return true;
+    }
+
+    // 뷰를 얻은 뒤 지금까지 슬롯이 덮어써지지 않았는지
+    bool still_valid(const SpectrumView& view) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return view.slot->seq.load(std::memory_order_relaxed) == view.seq_token;
+    }
+
+    // 일관된 최신 스윕을 out(, measured_out)에 복사 (capacity: 버퍼의 빈 수). 성공 시 info 채움
+    bool copy_latest(SpectrumSweepInfo& info, float* out, uint32_t capacity,
+                     uint8_t* measured_out = nullptr, int max_retries = 16) const {
+        for (int attempt = 0; attempt < max_retries; attempt++) {
+            SpectrumView view;
+            if (!acquire_latest(view, 1)) continue;
+            if (view.info.num_bins > capacity) return false;
+            memcpy(out, view.bins, (size_t)view.info.num_bins * sizeof(float));
+            if (measured_out) memcpy(measured_out, view.measured, view.info.num_bins);
+            if (still_valid(view)) {
+                info = view.info;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const SpectrumSlotMeta* slot_meta(uint64_t index) const {
+        return (const SpectrumSlotMeta*)(base_ + header_->header_size + index * header_->slot_stride);
+    }
+
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    const SpectrumShmHeader* header_ = nullptr;
+};
@@ -0,0 +1,287 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "spectrum_shm.h"
+
+// ==================== 스펙트럼 공유 메모리 reader ====================
+// wideband_sweeper가 게시하는 스펙트럼을 읽는 예제 겸 점검 도구 (bladeRF/GL 불필요)
+//
+//   spectrum_shm_reader                      : 새 스윕마다 요약 출력 (제자리 읽기)
+//   spectrum_shm_reader --stress N SEC       : reader 프로세스 N개(fork)로 SEC초 동안 일관성 검사
+//   spectrum_shm_reader --stress N SEC --synthetic
+//                                            : 내장 합성 writer로 최대 속도 게시하며 검사
+//   --name NAME                              : 세그먼트 이름 (기본 SPECTRUM_SHM_NAME)
+
+#define SYNTHETIC_SHM_NAME    "/bladerf_spectrum_selftest"
+#define SYNTHETIC_SLOTS       4         // 슬롯을 적게 잡아 덮어쓰기 경쟁을 늘림
+#define SYNTHETIC_MAX_BINS    200000
+#define WATCH_POLL_MS         50
+
+double now_seconds() {
+    using namespace std::chrono;
+    return duration<double>(system_clock::now().time_since_epoch()).count();
+}
+
+// ==================== 감시 모드 ====================
+int run_watch(const char* name) {
+    SpectrumShmReader reader;
+    if (!reader.open(name)) {
+        fprintf(stderr, "❌ 세그먼트 열기 실패: %s (wideband_sweeper 실행 중인지 확인)\n", name);
+        return 1;
+    }
+    const SpectrumShmHeader* header = reader.header();
+    printf("✓ %s: 슬롯 %u개, 최대 %u빈, 범위 %.1f ~ %.1f MHz\n", name,
+           header->slot_count, header->max_bins,
+           header->start_freq_hz / 1e6, header->end_freq_hz / 1e6);
+
+    uint64_t last_sequence = 0;
+    while (true) {
+        uint64_t sequence = reader.latest_sequence();
+        if (sequence == last_sequence) {
+            usleep(WATCH_POLL_MS * 1000);
+            continue;
+        }
+
+        SpectrumView view;
+        if (!reader.acquire_latest(view)) continue;
+
+        // 측정된 빈 중 피크 (공유 메모리에서 바로 읽음)
+        const SpectrumSweepInfo& info = view.info;
+        uint32_t peak_bin = info.first_bin;
+        uint32_t measured_bins = 0;
+        for (uint32_t i = info.first_bin; i <= info.last_bin && i < info.num_bins; i++) {
+            if (!view.measured[i]) continue;
+            if (measured_bins == 0 || view.bins[i] > view.bins[peak_bin]) peak_bin = i;
+            measured_bins++;
+        }
+        float peak_db = view.bins[peak_bin];
+
+        if (!reader.still_valid(view)) continue;   // 읽는 중 덮어써짐 → 다시
+
+        if (last_sequence != 0 && info.sequence > last_sequence + 1) {
+            printf("  (스윕 %llu개 건너뜀)\n", (unsigned long long)(info.sequence - last_sequence - 1));
+        }
+        last_sequence = info.sequence;
+
+        printf("#%llu 스윕 %llu: FFT %u, %u빈 중 측정 %u (%.2f kHz/빈), 피크 %.3f MHz %.1f dBFS, 지연 %.0f ms\n",
+               (unsigned long long)info.sequence, (unsigned long long)info.sweep_count,
+               info.fft_size, info.num_bins, measured_bins, info.hz_per_bin / 1e3,
+               (info.start_hz + peak_bin * info.hz_per_bin) / 1e6, peak_db,
+               (now_seconds() - info.timestamp) * 1000.0);
+    }
+    return 0;
+}
+
+// ==================== 스트레스 검사 ====================
+struct ReaderStats {
+    uint64_t views = 0;          // 검증된 제자리 읽기
+    uint64_t copies = 0;         // 검증된 복사 읽기
+    uint64_t retries = 0;        // 기록 중/덮어써져서 버린 읽기
+    uint64_t corrupt = 0;        // 검증 통과 후 체크섬 불일치 (있으면 안 됨)
+    uint64_t backwards = 0;      // 게시 번호 역행 (있으면 안 됨)
+};
+
+// reader 프로세스 본체: 자기 매핑으로 deadline까지 읽기. 열기 실패 시 false
+bool reader_loop(const char* name, double deadline, ReaderStats& stats) {
+    SpectrumShmReader reader;
+    if (!reader.open(name)) {
+        fprintf(stderr, "❌ reader %d: 세그먼트 열기 실패: %s\n", (int)getpid(), name);
+        return false;
+    }
+    std::vector<float> copy(reader.header()->max_bins);
+    std::vector<uint8_t> copy_measured(reader.header()->max_bins);
+    uint64_t last_sequence = 0;
+
+    while (now_seconds() < deadline) {
+        // 제자리 읽기: 체크섬 계산 후 still_valid()로 확인
+        SpectrumView view;
+        if (reader.acquire_latest(view, 1)) {
+            uint64_t checksum = spectrum_shm_checksum(view.bins, view.measured, view.info.num_bins);
+            if (!reader.still_valid(view)) {
+                stats.retries++;
+            } else {
+                stats.views++;
+                if (checksum != view.info.checksum) stats.corrupt++;
+                if (view.info.sequence < last_sequence) stats.backwards++;
+                last_sequence = view.info.sequence;
+            }
+        } else {
+            stats.retries++;
+        }
+
+        // 복사 읽기
+        SpectrumSweepInfo info;
+        if (reader.copy_latest(info, copy.data(), (uint32_t)copy.size(), copy_measured.data(), 1)) {
+            stats.copies++;
+            if (spectrum_shm_checksum(copy.data(), copy_measured.data(), info.num_bins) != info.checksum) {
+                stats.corrupt++;
+            }
+            if (info.sequence < last_sequence) stats.backwards++;
+            last_sequence = info.sequence;
+        } else {
+            stats.retries++;
+        }
+    }
+    return true;
+}
+
+// 합성 writer: 빈 수, 내용, 측정 플래그를 매번 바꿔가며 최대 속도로 게시
+void synthetic_writer_loop(SpectrumShmWriter& writer, std::atomic<bool>& running) {
+    std::vector<float> bins(SYNTHETIC_MAX_BINS);
+    std::vector<uint8_t> measured(SYNTHETIC_MAX_BINS);
+    const uint32_t sizes[] = {SYNTHETIC_MAX_BINS, SYNTHETIC_MAX_BINS / 2, SYNTHETIC_MAX_BINS / 8};
+
+    uint64_t sweep = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        sweep++;
+        uint32_t num_bins = sizes[sweep % 3];
+        for (uint32_t i = 0; i < num_bins; i++) {
+            bins[i] = -80.0f + (float)((i * 2654435761u + sweep * 40503u) % 6000) * 0.01f;
+            measured[i] = (uint8_t)((i + sweep) % 5 < 3);   // 스티칭처럼 약 40%는 채움값
+        }
+
+        SpectrumSweepInfo info = {};
+        info.sweep_count = sweep;
+        info.timestamp = now_seconds();
+        info.start_hz = 70e6;
+        info.hz_per_bin = 61.44e6 / 8192;
+        info.fft_size = 8192;
+        info.first_bin = 0;
+        info.last_bin = num_bins - 1;
+        writer.publish(info, bins.data(), measured.data(), num_bins);
+    }
+}
+
+// reader는 fork한 별도 프로세스: 각자 세그먼트를 매핑하므로 프로세스 간 게시/읽기를 실제로 검사
+// 결과는 파이프로 ReaderStats 한 건씩 (PIPE_BUF 이하라 원자적 쓰기)
+int run_stress(const char* name, int num_readers, double seconds, bool synthetic) {
+    SpectrumShmWriter writer;
+    if (synthetic &&
+        !writer.open(name, SYNTHETIC_SLOTS, SYNTHETIC_MAX_BINS, 70000000, 6000000000ULL, 61440000)) {
+        fprintf(stderr, "❌ 합성 세그먼트 생성 실패: %s (%s)\n", name, strerror(errno));
+        return 1;
+    }
+
+    printf("🔍 스트레스 검사: reader 프로세스 %d개, %.1f초, %s (%s)\n", num_readers, seconds,
+           synthetic ? "합성 writer" : "외부 writer", name);
+    fflush(stdout);   // fork 전에 비워 자식이 같은 출력을 다시 내보내지 않게
+
+    SpectrumShmReader probe;
+    if (!probe.open(name)) {
+        fprintf(stderr, "❌ 세그먼트 열기 실패: %s\n", name);
+        if (synthetic) {
+            writer.close();
+            shm_unlink(name);
+        }
+        return 1;
+    }
+    uint64_t first_sequence = probe.latest_sequence();
+
+    int result_pipe[2];
+    if (pipe(result_pipe) != 0) {
+        fprintf(stderr, "❌ 파이프 생성 실패: %s\n", strerror(errno));
+        return 1;
+    }
+
+    // writer 스레드를 띄우기 전에 fork (스레드가 잡은 malloc 락을 자식이 물려받지 않게)
+    double deadline = now_seconds() + seconds;
+    std::vector<pid_t> children;
+    for (int i = 0; i < num_readers; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            fprintf(stderr, "❌ reader fork 실패: %s\n", strerror(errno));
+            break;
+        }
+        if (pid == 0) {
+            // 자식: 부모의 writer를 닫지 않도록 소멸자 없이 _exit
+            ::close(result_pipe[0]);
+            ReaderStats stats;
+            bool opened = reader_loop(name, deadline, stats);
+            bool sent = opened && write(result_pipe[1], &stats, sizeof(stats)) == (ssize_t)sizeof(stats);
+            _exit(sent ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    ::close(result_pipe[1]);
+
+    std::atomic<bool> writer_running(true);
+    std::thread writer_thread;
+    if (synthetic) {
+        writer_thread = std::thread(synthetic_writer_loop, std::ref(writer), std::ref(writer_running));
+    }
+
+    int failed_readers = num_readers - (int)children.size();
+    for (pid_t pid : children) {
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed_readers++;
+    }
+    writer_running = false;
+    if (writer_thread.joinable()) writer_thread.join();
+
+    ReaderStats total;
+    ReaderStats s;
+    int reported = 0;
+    while (read(result_pipe[0], &s, sizeof(s)) == (ssize_t)sizeof(s)) {
+        total.views += s.views;
+        total.copies += s.copies;
+        total.retries += s.retries;
+        total.corrupt += s.corrupt;
+        total.backwards += s.backwards;
+        reported++;
+    }
+    ::close(result_pipe[0]);
+
+    printf("  게시: %llu스윕\n", (unsigned long long)(probe.latest_sequence() - first_sequence));
+    printf("  reader 프로세스: 보고 %d개, 실패 %d개\n", reported, failed_readers);
+    printf("  제자리 읽기: %llu, 복사 읽기: %llu, 재시도: %llu\n",
+           (unsigned long long)total.views, (unsigned long long)total.copies,
+           (unsigned long long)total.retries);
+    printf("  체크섬 불일치: %llu, 게시 번호 역행: %llu\n",
+           (unsigned long long)total.corrupt, (unsigned long long)total.backwards);
+
+    if (synthetic) {
+        writer.close();
+        shm_unlink(name);
+    }
+
+    bool ok = failed_readers == 0 && reported == num_readers &&
+              total.corrupt == 0 && total.backwards == 0 && total.views + total.copies > 0;
+    printf("%s\n", ok ? "✓ 일관성 검사 통과" : "❌ 일관성 검사 실패");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    const char* name = nullptr;
+    int num_readers = 0;
+    double seconds = 0.0;
+    bool synthetic = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (strcmp(argv[i], "--stress") == 0 && i + 2 < argc) {
+            num_readers = atoi(argv[++i]);
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--synthetic") == 0) {
+            synthetic = true;
+        } else {
+            fprintf(stderr, "사용법: %s [--name NAME] [--stress READERS SECONDS [--synthetic]]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!name) name = synthetic ? SYNTHETIC_SHM_NAME : SPECTRUM_SHM_NAME;
+
+    if (num_readers > 0) {
+        return run_stress(name, num_readers, seconds, synthetic);
+    }
+    return run_watch(name);
+}
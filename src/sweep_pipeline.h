@@ -0,0 +1,331 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "fft_plan_cache.h"
+#include "spectrum_frontend.h"
+#include "sweep_scheduler.h"
+
+// ==================== 스윕 파이프라인 ====================
+// 스윕 스레드가 스텝/스윕마다 하는 작업: 프레임 평균, 스티칭 범위 통계, 스티칭 배열과
+// 측정 마스크 기록, 워터폴 라인 추가, 렌더 스냅샷 복사.
+// bladeRF/GL/전역 상태와 무관하므로 정상 상태 할당 테스트가 실제 경로를 그대로 구동한다.
+
+// ========== 스티칭 배열 + 워터폴 ==========
+// 배열은 start_freq - sample_rate/2 ~ end_freq + sample_rate/2 를 덮음 (양쪽 확장)
+struct StitchedSpectrum {
+    uint64_t start_freq = 0;
+    uint64_t end_freq = 0;
+    uint32_t sample_rate = 0;
+    size_t waterfall_history = 0;          // 워터폴 링 버퍼 라인 수
+
+    std::vector<float> full_spectrum;      // 현재 스펙트럼
+    std::vector<float> peak_spectrum;      // Peak hold
+
+    // 워터폴 링 버퍼 (waterfall_history 라인 × total_bins, 미리 할당)
+    std::vector<float> waterfall_buffer;
+    size_t waterfall_head = 0;    // 다음에 쓸 라인
+    size_t waterfall_count = 0;   // 유효 라인 수
+
+    // FFT 크기에 맞춰 스티칭 배열과 워터폴 크기 재조정 (내용은 초기화됨)
+    void configure_spectrum(int size) {
+        size_t total_bins = spectrum_bins_for(size);
+        full_spectrum.assign(total_bins, -80.0f);
+        peak_spectrum.assign(total_bins, -120.0f);
+        waterfall_buffer.assign(waterfall_history * total_bins, -80.0f);
+        waterfall_head = 0;
+        waterfall_count = 0;
+    }
+
+    // FFT 크기별 스티칭 배열 길이
+    size_t spectrum_bins_for(int size) const {
+        // 양쪽으로 여유 공간 추가 (±sample_rate/2)
+        uint64_t total_bandwidth = end_freq - start_freq;
+        uint64_t extended_bandwidth = total_bandwidth + sample_rate;  // 양쪽 확장
+        return (extended_bandwidth / (sample_rate / size)) + size;
+    }
+
+    // 스티칭 배열의 주파수 축: index → array_start_hz() + index * hz_per_array_bin()
+    double array_start_hz() const {
+        return (double)start_freq - sample_rate / 2.0;
+    }
+
+    double hz_per_array_bin() const {
+        return (double)(end_freq - start_freq + sample_rate) / full_spectrum.size();
+    }
+
+    // 새 스윕 시작: 과거 주파수 데이터 제거
+    void clear_sweep() {
+        std::fill(full_spectrum.begin(), full_spectrum.end(), -80.0f);
+        std::fill(peak_spectrum.begin(), peak_spectrum.end(), -120.0f);
+        clear_waterfall();
+    }
+
+    void add_waterfall_line() {
+        size_t total_bins = full_spectrum.size();
+        std::copy(full_spectrum.begin(), full_spectrum.end(),
+                  waterfall_buffer.begin() + waterfall_head * total_bins);
+        waterfall_head = (waterfall_head + 1) % waterfall_history;
+        if (waterfall_count < waterfall_history) waterfall_count++;
+    }
+
+    void clear_waterfall() {
+        waterfall_head = 0;
+        waterfall_count = 0;
+    }
+
+    // age=0이 최신 라인
+    const float* waterfall_line(size_t age) const {
+        size_t index = (waterfall_head + waterfall_history - 1 - age) % waterfall_history;
+        return waterfall_buffer.data() + index * full_spectrum.size();
+    }
+};
+
+// ========== 스윕 작업 버퍼 ==========
+// 스윕 스레드의 작업 버퍼를 구성(FFT 크기, 최대 캡처 길이)마다 한 번만 할당
+// 정상 상태 스윕 루프에서는 힙 할당이 발생하지 않음
+struct SweepArena {
+    std::vector<int16_t> iq_buffer;     // 최대 체류 시간의 IQ 샘플 (SC16 Q11, I/Q 교차)
+    std::vector<float> fft_result;      // 프레임 하나의 dBFS 스펙트럼 (FFT shift 적용)
+    std::vector<float> avg_spectrum;    // 프레임 평균 스펙트럼
+    std::vector<uint8_t> measured;      // 이번 스윕에 측정값이 기록된 스티칭 배열 빈 (1 = 기록됨)
+
+    void configure(int fft_size, size_t max_iq_samples, size_t total_bins) {
+        iq_buffer.assign(max_iq_samples * 2, 0);
+        fft_result.assign(fft_size, 0.0f);
+        avg_spectrum.assign(fft_size, 0.0f);
+        measured.assign(total_bins, 0);
+    }
+};
+
+// ========== 스텝 처리 ==========
+// 스티칭에 사용할 FFT 빈 범위: 중심에서 ±step_hz/2 만 사용
+// (바깥쪽 안티앨리어싱 롤오프 구간은 버림)
+struct StitchRange {
+    int first;
+    int last;
+    int count;
+};
+
+inline StitchRange stitch_range(int fft_size, uint32_t sample_rate, uint64_t step_hz) {
+    double hz_per_bin = (double)sample_rate / (double)fft_size;
+    int use_half_bins = (int)floor((double)(step_hz / 2) / hz_per_bin);
+
+    StitchRange range;
+    range.first = std::max(0, fft_size / 2 - use_half_bins);
+    range.last = std::min(fft_size - 1, fft_size / 2 + use_half_bins);
+    range.count = range.last - range.first + 1;
+    return range;
+}
+
+// frames개 프레임의 dBFS 스펙트럼 평균 → avg_spectrum
+// 프레임 f는 iq + f * frame_stride 샘플에서 시작 (길이는 프런트엔드 캡처 길이)
+// 스윕 스레드는 frame_stride = fft_size: PFB 프레임은 taps 구간이 겹치므로
+// frames개에 (taps + frames - 1) × fft_size 샘플만 필요
+inline void average_frames(const FftSetup& fft, bool use_pfb, int dc_mode, int dc_half_width,
+                           const int16_t* iq, size_t frame_stride, int frames,
+                           float* fft_result, float* avg_spectrum) {
+    const int fft_size = fft.size();
+    std::fill(avg_spectrum, avg_spectrum + fft_size, 0.0f);
+
+    for (int frame = 0; frame < frames; frame++) {
+        compute_spectrum(fft, use_pfb, iq + (size_t)frame * frame_stride * 2, fft_result);
+        apply_dc_handling(fft_result, fft_size, dc_mode, dc_half_width);
+
+        // 누적
+        for (int i = 0; i < fft_size; i++) {
+            avg_spectrum[i] += fft_result[i];
+        }
+    }
+
+    // 평균 계산
+    for (int i = 0; i < fft_size; i++) {
+        avg_spectrum[i] /= frames;
+    }
+}
+
+// 스티칭되는 빈만의 최소/평균/최대/분산 (디버그 출력 + 스케줄러 활동 점수)
+struct StepStats {
+    float min_db;
+    float mean_db;
+    float max_db;
+    float variance_db;   // 빈 간 분산 (dB^2)
+};
+
+inline StepStats measure_step(const float* avg_spectrum, StitchRange range) {
+    float sum = 0.0f;
+    float sq_sum = 0.0f;
+    float max_power = -200.0f;
+    float min_power = 200.0f;
+    for (int i = range.first; i <= range.last; i++) {
+        sum += avg_spectrum[i];
+        sq_sum += avg_spectrum[i] * avg_spectrum[i];
+        if (avg_spectrum[i] > max_power) max_power = avg_spectrum[i];
+        if (avg_spectrum[i] < min_power) min_power = avg_spectrum[i];
+    }
+
+    StepStats stats;
+    stats.mean_db = sum / range.count;
+    stats.min_db = min_power;
+    stats.max_db = max_power;
+    stats.variance_db = fmaxf(0.0f, sq_sum / range.count - stats.mean_db * stats.mean_db);
+    return stats;
+}
+
+// ========== 잡음 기준선 ==========
+// 합성 복소 가우시안 잡음 (SC16, 결정적 LCG + Box-Muller)
+inline void fill_gaussian_noise(int16_t* iq, size_t samples, float sigma, uint32_t& state) {
+    for (size_t n = 0; n < samples; n++) {
+        state = state * 1664525u + 1013904223u;
+        float u1 = ((state >> 8) + 0.5f) / 16777216.0f;
+        state = state * 1664525u + 1013904223u;
+        float u2 = (state >> 8) / 16777216.0f;
+        float r = sigma * sqrtf(-2.0f * logf(u1));
+        iq[2 * n] = (int16_t)lrintf(r * cosf(2.0f * (float)M_PI * u2));
+        iq[2 * n + 1] = (int16_t)lrintf(r * sinf(2.0f * (float)M_PI * u2));
+    }
+}
+
+// 잡음만 있는 스텝의 통계를 스윕 경로(average_frames + measure_step) 그대로 측정해
+// 체류 청크 수별 기준선으로 스케줄러에 설정. FFT 크기/윈도우/프런트엔드/DC 처리/스텝이
+// 바뀔 때마다 호출 (작업 버퍼만 사용하므로 할당 없음)
+// frame_samples: 프레임 하나의 캡처 길이, frame_stride: 프레임 간 간격 (샘플)
+inline void calibrate_noise_baseline(SweepScheduler& scheduler, const FftSetup& fft, bool use_pfb,
+                                     int dc_mode, int dc_half_width, StitchRange range,
+                                     size_t frame_stride, size_t frame_samples, SweepArena& arena,
+                                     int runs = 4) {
+    const SweepSchedulerConfig& config = scheduler.config();
+    uint32_t state = 0x9e3779b9u;
+    for (int dwell = config.min_dwell_chunks; dwell <= config.max_dwell_chunks; dwell++) {
+        size_t samples = (size_t)(dwell - 1) * frame_stride + frame_samples;
+        if (samples * 2 > arena.iq_buffer.size()) break;
+
+        float variance = 0.0f;
+        float peak_excess = 0.0f;
+        for (int run = 0; run < runs; run++) {
+            fill_gaussian_noise(arena.iq_buffer.data(), samples, 64.0f, state);
+            average_frames(fft, use_pfb, dc_mode, dc_half_width, arena.iq_buffer.data(), frame_stride,
+                           dwell, arena.fft_result.data(), arena.avg_spectrum.data());
+            StepStats stats = measure_step(arena.avg_spectrum.data(), range);
+            variance += stats.variance_db;
+            peak_excess += stats.max_db - stats.mean_db;
+        }
+        scheduler.set_noise_baseline(dwell, variance / runs, peak_excess / runs);
+    }
+}
+
+// 스티칭 배열에 기록된 인덱스 범위
+struct StitchResult {
+    size_t first_index;
+    size_t last_index;
+    size_t num_written;
+};
+
+// 중심 주파수 freq의 평균 스펙트럼을 스티칭 배열에 기록하고 measured에 표시
+// 각 FFT 빈 중심 주파수 → 가장 가까운 배열 인덱스 (배열 축과 같은 double 간격)
+inline StitchResult stitch_step(StitchedSpectrum& spectrum, uint8_t* measured, const float* avg_spectrum,
+                                int fft_size, StitchRange range, uint64_t freq, bool peak_hold) {
+    size_t total_bins = spectrum.full_spectrum.size();
+    double hz_per_bin = (double)spectrum.sample_rate / (double)fft_size;
+    double hz_per_array_bin = spectrum.hz_per_array_bin();
+    double center_index = ((double)freq - spectrum.array_start_hz()) / hz_per_array_bin;
+
+    StitchResult result;
+    result.first_index = total_bins;
+    result.last_index = 0;
+    result.num_written = 0;
+
+    for (int i = range.first; i <= range.last; i++) {
+        // FFT 빈 i가 나타내는 주파수 오프셋 (중심 주파수 기준)
+        double freq_offset_hz = (i - fft_size / 2.0) * hz_per_bin;
+        int64_t global_index = (int64_t)floor(center_index + freq_offset_hz / hz_per_array_bin + 0.5);
+        if (global_index < 0 || global_index >= (int64_t)total_bins) continue;
+
+        result.num_written++;
+        if ((size_t)global_index < result.first_index) result.first_index = global_index;
+        if ((size_t)global_index > result.last_index) result.last_index = global_index;
+
+        // 직접 덮어쓰기 (블렌딩 없음)
+        float new_value = avg_spectrum[i];
+        spectrum.full_spectrum[global_index] = new_value;
+        measured[global_index] = 1;
+
+        if (peak_hold) {
+            float& peak = spectrum.peak_spectrum[global_index];
+            if (new_value > peak) {
+                peak = new_value;
+            } else {
+                peak -= 0.05f;
+            }
+        }
+    }
+    return result;
+}
+
+// ========== 렌더 스냅샷 ==========
+// 렌더 스레드 전용: 잠금 구간에서는 표시 범위만 복사하고 그리기는 잠금 해제 후 수행
+// 버퍼는 최대 FFT 크기 기준으로 한 번만 할당 (configure_render_snapshot)
+struct RenderSnapshot {
+    std::vector<float> spectrum;     // 표시 범위 스펙트럼 (num_points)
+    std::vector<float> peak;         // 표시 범위 Peak hold
+    std::vector<float> waterfall;    // 워터폴 라인 수 × num_points, 라인 0 = 최신
+    size_t num_points = 0;
+    size_t waterfall_lines = 0;
+    bool peak_hold = false;
+
+    float db_min = 0.0f;
+    float db_max = 0.0f;
+    bool adjust_mode = false;
+    uint64_t start_freq = 0;
+    uint64_t end_freq = 0;
+    uint64_t current_freq = 0;
+    int sweep_count = 0;
+    int fft_size = 0;
+    WindowType window_type = WINDOW_HANN;
+    FrontEnd frontend = FRONTEND_FFT;
+};
+
+inline void configure_render_snapshot(RenderSnapshot& snap, size_t max_points, size_t waterfall_history) {
+    snap.spectrum.assign(max_points, 0.0f);
+    snap.peak.assign(max_points, 0.0f);
+    snap.waterfall.assign(waterfall_history * max_points, 0.0f);
+}
+
+// 스티칭 배열의 표시 범위(start_freq ~ end_freq)와 워터폴을 스냅샷으로 복사
+// 호출자가 스펙트럼 잠금을 보유한 상태에서 호출 (잠금 시간 = 복사 시간)
+inline bool snapshot_spectrum(const StitchedSpectrum& spectrum, bool peak_hold, RenderSnapshot& snap) {
+    size_t total_bins = spectrum.full_spectrum.size();
+    if (total_bins == 0) return false;
+
+    // 배열은 확장되어 있지만 표시는 start_freq ~ end_freq만
+    uint64_t display_range = spectrum.end_freq - spectrum.start_freq;
+    uint64_t array_range = display_range + spectrum.sample_rate;
+
+    // 배열에서 실제 표시할 범위의 시작/끝 인덱스 계산
+    size_t display_start_index = (size_t)(spectrum.sample_rate / 2.0 / array_range * total_bins);
+    size_t display_end_index = display_start_index +
+                               (size_t)((double)display_range / array_range * total_bins);
+    size_t num_points = display_end_index - display_start_index;
+    if (num_points < 2 || num_points > snap.spectrum.size()) return false;
+
+    const float* full = spectrum.full_spectrum.data() + display_start_index;
+    std::copy(full, full + num_points, snap.spectrum.begin());
+    snap.peak_hold = peak_hold;
+    if (peak_hold) {
+        const float* peak = spectrum.peak_spectrum.data() + display_start_index;
+        std::copy(peak, peak + num_points, snap.peak.begin());
+    }
+
+    snap.waterfall_lines = spectrum.waterfall_count;
+    for (size_t line = 0; line < snap.waterfall_lines; line++) {
+        const float* src = spectrum.waterfall_line(line) + display_start_index;
+        std::copy(src, src + num_points, snap.waterfall.begin() + line * num_points);
+    }
+
+    snap.num_points = num_points;
+    snap.start_freq = spectrum.start_freq;
+    snap.end_freq = spectrum.end_freq;
+    return true;
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+// ==================== 적응형 스윕 스케줄러 ====================
+// 스텝별 활동 점수(분산, 피크-플로어 차, 최근 변화량)를 유지하고
+// 점수에 따라 재방문 빈도와 체류 시간(청크 수)을 배분한다.
+// 각 성분은 잡음만 있을 때의 기준선을 넘는 만큼만 점수가 된다: dB 주기도는 잡음만으로도
+// 빈 간 분산이 크고(프레임 1개 ≈ 31 dB², 평균 프레임 수에 반비례) 수천 빈의 최대값이
+// 평균보다 ≈ 12 dB 높으므로, 그대로 점수화하면 조용한 스텝도 체류가 늘어난다.
+// 하드웨어와 무관한 순수 로직이므로 합성 활동 패턴으로 결정적으로 검증할 수 있다.
+//
+// 슬롯 = 한 번의 튜닝/캡처. 각 슬롯마다 next()가 방문할 스텝을 고른다.
+//  - 우선순위 = 경과 슬롯 수 * (1 + activity_gain * 점수)
+//  - 경과 슬롯 수가 max_revisit_slots 이상인 스텝은 "기한 초과"로 가장 오래된 것부터 강제 방문
+//    → 모든 스텝의 재방문 간격은 max_revisit_slots + num_steps - 1 슬롯을 넘지 않음
+//  - 동점이면 낮은 스텝 번호 우선 (첫 패스는 주파수 오름차순)
+
+// 스텝 하나의 측정 요약 (dB 단위)
+struct StepActivity {
+    float mean_db;       // 평균 레벨 (플로어 추정)
+    float peak_db;       // 최대 레벨
+    float variance_db;   // 빈 간 분산 (dB^2)
+    int dwell_chunks;    // 평균한 프레임 수 (잡음 기준선 선택)
+};
+
+// 스케줄러 결정
+struct SweepVisit {
+    int step;            // 방문할 스텝 번호 (0 = start_freq)
+    int dwell_chunks;    // 평균화할 청크 수
+    bool forced;         // 최소 재방문 보장으로 강제 선택됨
+};
+
+struct SweepSchedulerConfig {
+    int min_dwell_chunks = 1;
+    int max_dwell_chunks = 4;
+    int max_revisit_slots = 0;       // 0 → 스텝 수의 1.5배
+    float score_alpha = 0.3f;        // 활동 점수 EMA 계수 (새 값 비중)
+    float activity_gain = 4.0f;      // 점수가 우선순위에 미치는 가중치
+
+    // 점수 정규화 기준 (이 값에서 해당 성분이 1.0)
+    float peak_ref_db = 20.0f;       // 피크 - 평균
+    float variance_ref_db2 = 25.0f;  // 빈 간 분산
+    float change_ref_db = 6.0f;      // 직전 방문 대비 평균/피크 변화량
+
+    // 잡음 기준선 기본값 (set_noise_baseline으로 실측값을 넣기 전)
+    float noise_variance_db2 = 31.0f;    // 프레임 1개의 빈 간 분산, 체류 청크 수로 나눔
+    float noise_peak_excess_db = 12.0f;  // 피크 - 평균
+    // 기준선 위 여유: 이 이하의 초과분은 잡음 변동으로 간주
+    float noise_peak_margin_db = 3.0f;
+    float noise_variance_margin = 0.5f;  // 기준 분산에 대한 비율
+};
+
+class SweepScheduler {
+public:
+    void configure(int num_steps, const SweepSchedulerConfig& config) {
+        config_ = config;
+        if (config_.min_dwell_chunks < 1) config_.min_dwell_chunks = 1;
+        if (config_.max_dwell_chunks < config_.min_dwell_chunks) {
+            config_.max_dwell_chunks = config_.min_dwell_chunks;
+        }
+        if (config_.max_revisit_slots <= 0) {
+            config_.max_revisit_slots = num_steps + num_steps / 2;
+        }
+        if (config_.max_revisit_slots < num_steps) {
+            config_.max_revisit_slots = num_steps;
+        }
+
+        num_steps_ = num_steps;
+        slot_ = 0;
+        score_.assign(num_steps, 0.0f);
+        last_visit_.assign(num_steps, 0);
+        prev_mean_.assign(num_steps, 0.0f);
+        prev_peak_.assign(num_steps, 0.0f);
+        has_prev_.assign(num_steps, 0);
+        visited_.assign(num_steps, 0);
+        unvisited_ = num_steps;
+
+        noise_variance_.assign(config_.max_dwell_chunks + 1, 0.0f);
+        noise_peak_.assign(config_.max_dwell_chunks + 1, config_.noise_peak_excess_db);
+        for (int dwell = 1; dwell <= config_.max_dwell_chunks; dwell++) {
+            noise_variance_[dwell] = config_.noise_variance_db2 / dwell;
+        }
+    }
+
+    // 잡음만 있는 스텝을 dwell_chunks 프레임 평균했을 때의 빈 간 분산과 (피크 - 평균)
+    // (실제 FFT/윈도우/프런트엔드/스티칭 범위로 측정한 값, calibrate_noise_baseline 참고)
+    void set_noise_baseline(int dwell_chunks, float variance_db2, float peak_excess_db) {
+        if (dwell_chunks < 1 || dwell_chunks > config_.max_dwell_chunks) return;
+        noise_variance_[dwell_chunks] = variance_db2;
+        noise_peak_[dwell_chunks] = peak_excess_db;
+    }
+
+    // 새 스윕 시작: 커버리지 추적 초기화 (점수와 방문 기록은 유지)
+    void begin_sweep() {
+        for (int i = 0; i < num_steps_; i++) visited_[i] = 0;
+        unvisited_ = num_steps_;
+    }
+
+    // 이번 스윕에서 모든 스텝을 한 번 이상 방문했는지
+    bool coverage_complete() const { return unvisited_ == 0; }
+
+    SweepVisit next() {
+        slot_++;
+
+        int best = 0;
+        bool forced = false;
+        uint64_t best_age = 0;
+        float best_priority = -1.0f;
+
+        for (int i = 0; i < num_steps_; i++) {
+            uint64_t a = age(i);
+            bool overdue = a >= (uint64_t)config_.max_revisit_slots;
+
+            if (overdue) {
+                // 기한 초과 스텝은 가장 오래된 것부터
+                if (!forced || a > best_age) {
+                    best = i;
+                    best_age = a;
+                    forced = true;
+                }
+                continue;
+            }
+            if (forced) continue;
+
+            float priority = (float)a * (1.0f + config_.activity_gain * score_[i]);
+            if (priority > best_priority) {
+                best = i;
+                best_priority = priority;
+            }
+        }
+
+        last_visit_[best] = slot_;
+        if (!visited_[best]) {
+            visited_[best] = 1;
+            unvisited_--;
+        }
+
+        SweepVisit visit;
+        visit.step = best;
+        visit.dwell_chunks = dwell_for(score_[best]);
+        visit.forced = forced;
+        return visit;
+    }
+
+    // 방문 결과 보고 → 활동 점수 갱신
+    void report(int step, const StepActivity& activity) {
+        if (step < 0 || step >= num_steps_) return;
+
+        int dwell = activity.dwell_chunks;
+        if (dwell < 1) dwell = 1;
+        if (dwell > config_.max_dwell_chunks) dwell = config_.max_dwell_chunks;
+
+        // 잡음 기준선을 넘는 만큼만 점수화
+        float noise_peak = noise_peak_[dwell] + config_.noise_peak_margin_db;
+        float noise_variance = noise_variance_[dwell] * (1.0f + config_.noise_variance_margin);
+        float peak_term = clamp01((activity.peak_db - activity.mean_db - noise_peak) / config_.peak_ref_db);
+        float variance_term = clamp01((activity.variance_db - noise_variance) / config_.variance_ref_db2);
+
+        // 피크는 잡음 피크 수준 아래를 잘라서 비교 (잡음 최대값의 방문 간 흔들림은 변화가 아님)
+        float peak_level = fmaxf(activity.peak_db, activity.mean_db + noise_peak);
+        float change_term = 0.0f;
+        if (has_prev_[step]) {
+            float change = fabsf(activity.mean_db - prev_mean_[step]) +
+                           fabsf(peak_level - prev_peak_[step]);
+            change_term = clamp01(change / config_.change_ref_db);
+        }
+
+        float instant = 0.4f * peak_term + 0.3f * variance_term + 0.3f * change_term;
+        score_[step] += config_.score_alpha * (instant - score_[step]);
+
+        prev_mean_[step] = activity.mean_db;
+        prev_peak_[step] = peak_level;
+        has_prev_[step] = 1;
+    }
+
+    int num_steps() const { return num_steps_; }
+    uint64_t slot() const { return slot_; }
+    float score(int step) const { return score_[step]; }
+    float noise_variance(int dwell_chunks) const { return noise_variance_[dwell_chunks]; }
+    float noise_peak_excess(int dwell_chunks) const { return noise_peak_[dwell_chunks]; }
+    const SweepSchedulerConfig& config() const { return config_; }
+
+    // 마지막 방문 이후 경과 슬롯 수 (아직 방문 안 했으면 현재 슬롯 번호 + 스텝 순서 가산)
+    uint64_t age(int step) const {
+        if (last_visit_[step] == 0) return slot_ + (uint64_t)(num_steps_ - step);
+        return slot_ - last_visit_[step];
+    }
+
+    // 재방문 간격 상한 (슬롯)
+    uint64_t revisit_bound() const {
+        return (uint64_t)config_.max_revisit_slots + (uint64_t)num_steps_ - 1;
+    }
+
+private:
+    static float clamp01(float v) { return fmaxf(0.0f, fminf(1.0f, v)); }
+
+    int dwell_for(float score) const {
+        int span = config_.max_dwell_chunks - config_.min_dwell_chunks;
+        return config_.min_dwell_chunks + (int)lroundf(score * span);
+    }
+
+    SweepSchedulerConfig config_;
+    int num_steps_ = 0;
+    uint64_t slot_ = 0;
+    std::vector<float> score_;
+    std::vector<uint64_t> last_visit_;
+    std::vector<float> prev_mean_;
+    std::vector<float> prev_peak_;
+    std::vector<uint8_t> has_prev_;
+    std::vector<uint8_t> visited_;
+    int unvisited_ = 0;
+    std::vector<float> noise_variance_;   // 체류 청크 수별 잡음 기준선
+    std::vector<float> noise_peak_;
+};
@@ -5,38 +5,74 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cerrno>
 #include <cmath>
 #include <vector>
-#include <deque>
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
 #include <unistd.h>
+#include "sweep_scheduler.h"
+#include "alloc_counter.h"
+#include "fft_plan_cache.h"
+#include "spectrum_frontend.h"
+#include "occupancy_stats.h"
+#include "occupancy_checkpoint.h"
+#include "spectrum_shm.h"
+#include "sweep_pipeline.h"
 
 // ==================== 설정 상수 ====================
-#define FFT_SIZE              8192
+#define DEFAULT_FFT_SIZE      8192      // 기본 RBW ≈ 7.5 kHz
+#define MIN_FFT_SIZE          1024      // RBW 60 kHz
+#define MAX_FFT_SIZE          65536     // RBW ≈ 0.94 kHz
 #define RX_GAIN               30        // 40 → 30으로 조정
 #define CHANNEL               BLADERF_CHANNEL_RX(0)
 #define SAMPLE_RATE           61440000  // 61.44 MSPS
 #define START_FREQ_MHZ        80
 #define END_FREQ_MHZ          110
-#define STEP_SIZE_MHZ         50        // 50 MHz 단계
+#define STEP_SIZE_MHZ         50        // 50 MHz 단계 (Hann FFT 프런트엔드)
+#define PFB_STEP_SIZE_MHZ     52        // PFB 프런트엔드 단계 (아날로그 LPF 56 MHz 가장자리에서 ±2 MHz 여유)
+#define ANALOG_EDGE_MARGIN_MHZ 4        // 스텝 ≤ 실제 아날로그 대역폭 - 여유 (LPF 가장자리 롤오프 제외)
+#define RETUNE_SETTLE_US      1000      // 튜닝 후 정착 시간
+#define PFB_TAPS              8         // PFB 프로토타입 필터 탭 수 (FFT 크기 배수)
+#define PFB_BIN_WIDTH         1.5       // PFB 빈 통과대역 폭 (빈 단위, 1.5 → 스캘럽 손실 < 0.1 dB)
+#define DC_NOTCH_HZ           10000     // DC 처리 폭 (중심 ± Hz, 최소 1빈)
 #define WATERFALL_HISTORY     20       // 워터폴 히스토리 라인 수
+#define MAX_DWELL_CHUNKS      4         // 활동이 많은 스텝의 최대 체류 청크 수
+#define ALLOC_WARMUP_SWEEPS   1         // 이 스윕 수 이후로는 힙 할당이 없어야 함
+#define ALLOC_CHECK_ABORT     0         // 1이면 정상 상태 힙 할당 시 abort
+#define OCCUPANCY_THRESHOLD_DB    -60.0f  // 점유 판정 레벨 (dBFS)
+#define OCCUPANCY_CHECKPOINT_SEC  300     // 점유율 통계 체크포인트 주기 (초)
+#define OCCUPANCY_CHECKPOINT_FMT  "occupancy_%d.ckpt"  // FFT 크기별 체크포인트 파일
+#define SPECTRUM_SHM_SLOTS    8         // 게시 슬롯 수 (reader는 SLOTS-1 스윕 동안 제자리 읽기 가능)
+
+// ==================== 스펙트럼 프런트엔드 ====================
+// 스펙트럼(프레임) 하나를 만드는 데 필요한 IQ 샘플 수
+int samples_per_spectrum(int frontend, int fft_size) {
+    return frontend == FRONTEND_PFB ? fft_size * PFB_TAPS : fft_size;
+}
+
+// frames개 프레임을 평균하는 방문 한 번의 캡처 길이
+// 프레임 간격은 fft_size (PFB는 taps 구간이 겹치는 WOLA 프레임) → (taps + frames - 1) × fft_size
+int capture_samples(int frontend, int fft_size, int frames) {
+    int taps = frontend == FRONTEND_PFB ? PFB_TAPS : 1;
+    return (taps + frames - 1) * fft_size;
+}
+
+// 작업 버퍼: 최대 체류 청크 수만큼의 IQ (PFB 캡처 길이 기준)
+void configure_sweep_arena(SweepArena& arena, int fft_size, size_t total_bins) {
+    arena.configure(fft_size, (size_t)capture_samples(FRONTEND_PFB, fft_size, MAX_DWELL_CHUNKS), total_bins);
+}
 
 // ==================== 전역 상태 ====================
-struct WidebandState {
+// 스티칭 배열/워터폴(StitchedSpectrum)은 mutex 하에서 스윕 스레드가 쓰고 렌더 스레드가 복사
+struct WidebandState : StitchedSpectrum {
     std::atomic<bool> running{true};
     std::mutex mutex;
     
-    // 스펙트럼 데이터
-    std::vector<float> full_spectrum;      // 현재 스펙트럼
-    std::vector<float> peak_spectrum;      // Peak hold
-    std::vector<float> avg_spectrum_acc;   // 평균 누적
-    std::deque<std::vector<float>> waterfall_history;
-    uint64_t start_freq;
-    uint64_t end_freq;
     uint64_t current_freq;
-    int num_chunks;
+    int num_chunks;   // 최소 체류 청크 수 (조용한 스텝)
     int sweep_count;
     // 평균화 설정
     float avg_alpha;  // Exponential averaging factor (0.0 ~ 1.0)
@@ -47,18 +83,36 @@ struct WidebandState {
     float db_max;
     bool adjust_mode;
     
-    // FFT 관련
-    fftw_complex* fft_in;
-    fftw_complex* fft_out;
-    fftw_plan fft_plan;
-    std::vector<float> window;
+    // 렌더링 dirty 추적 (변경이 있을 때만 프레임 생성)
+    std::atomic<uint64_t> data_generation{0};   // 스텝/스윕 데이터 갱신 시 증가
+    std::atomic<uint64_t> view_generation{0};   // dB 범위, 조정 모드, 윈도우 노출 시 증가
+    
+    // FFT 관련 (스윕 스레드 전용, fft_size/window_type/frontend는 mutex 하에서 갱신)
+    FftPlanCache fft_cache{PFB_TAPS, PFB_BIN_WIDTH};
+    FftSetup fft;
+    int fft_size;
+    WindowType window_type;
+    FrontEnd frontend;
+    
+    // 키 입력으로 요청된 FFT 설정 (스윕 스레드가 스윕 경계에서 적용)
+    std::atomic<int> requested_fft_size{DEFAULT_FFT_SIZE};
+    std::atomic<int> requested_window_type{WINDOW_HANN};
+    std::atomic<int> requested_frontend{FRONTEND_FFT};
+    std::atomic<int> dc_mode{DC_INTERPOLATE};   // 스텝마다 바로 반영
+    uint32_t analog_bandwidth;   // 아날로그 LPF 실제 대역폭 (bladerf_set_bandwidth 결과, 0 = 미설정)
+    
+    // 점유율 보고 요청 (스윕 스레드가 스윕 끝에서 출력)
+    std::atomic<bool> occupancy_report_requested{false};
     
     WidebandState() {
         start_freq = START_FREQ_MHZ * 1000000ULL;
         end_freq = END_FREQ_MHZ * 1000000ULL;
+        sample_rate = SAMPLE_RATE;
+        waterfall_history = WATERFALL_HISTORY;
         current_freq = start_freq;
         num_chunks = 1;  // 2 → 1로 줄임 (평균화 감소)
         sweep_count = 0;
+        analog_bandwidth = 0;
         
         // 평균화 설정
         avg_alpha = 0.3f;  // 0.3 = 새 데이터 30%, 이전 70%
@@ -69,48 +123,60 @@ struct WidebandState {
         db_max = -10.0f;   // -30 → -10
         adjust_mode = false;
         
-        // 스펙트럼 배열 초기화
-        // 양쪽으로 여유 공간 추가 (±SAMPLE_RATE/2)
-        uint64_t total_bandwidth = end_freq - start_freq;
-        uint64_t extended_bandwidth = total_bandwidth + SAMPLE_RATE;  // 양쪽 확장
-        size_t total_bins = (extended_bandwidth / (SAMPLE_RATE / FFT_SIZE)) + FFT_SIZE;
-        full_spectrum.resize(total_bins, -80.0f);
-        peak_spectrum.resize(total_bins, -120.0f);
-        avg_spectrum_acc.resize(total_bins, -80.0f);
-        
-        // FFT 초기화
-        fft_in = fftw_alloc_complex(FFT_SIZE);
-        fft_out = fftw_alloc_complex(FFT_SIZE);
-        fft_plan = fftw_plan_dft_1d(FFT_SIZE, fft_in, fft_out, FFTW_FORWARD, FFTW_ESTIMATE);
+        // FFT 초기화 (Hann 윈도우)
+        fft_size = DEFAULT_FFT_SIZE;
+        window_type = WINDOW_HANN;
+        frontend = FRONTEND_FFT;
+        fft = fft_cache.get(fft_size, window_type);
         
-        // Hann 윈도우 생성
-        window.resize(FFT_SIZE);
-        for (int i = 0; i < FFT_SIZE; i++) {
-            window[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (FFT_SIZE - 1)));
-        }
-    }
-    
-    ~WidebandState() {
-        fftw_destroy_plan(fft_plan);
-        fftw_free(fft_in);
-        fftw_free(fft_out);
+        // 스펙트럼 배열 초기화
+        configure_spectrum(fft_size);
     }
     
-    void add_waterfall_line() {
-        waterfall_history.push_back(full_spectrum);
-        if (waterfall_history.size() > WATERFALL_HISTORY) {
-            waterfall_history.pop_front();
-        }
+    bool fft_config_pending() const {
+        return requested_fft_size.load() != fft_size ||
+               requested_window_type.load() != window_type ||
+               requested_frontend.load() != frontend;
     }
 };
 
 static WidebandState wideband_state;
 
+// 프런트엔드별 스텝 간격 (통과대역이 평탄한 PFB는 캡처 대역의 더 많은 부분을 사용)
+// 실제 아날로그 대역폭을 알면 가장자리 롤오프 구간이 스티칭되지 않도록 대역폭 - 여유로 제한
+uint64_t capture_step_hz(int frontend) {
+    uint64_t step_hz = (frontend == FRONTEND_PFB ? PFB_STEP_SIZE_MHZ : STEP_SIZE_MHZ) * 1000000ULL;
+    uint64_t bandwidth = wideband_state.analog_bandwidth;
+    uint64_t margin = ANALOG_EDGE_MARGIN_MHZ * 1000000ULL;
+    if (bandwidth > margin && step_hz > bandwidth - margin) {
+        step_hz = (bandwidth - margin) / 1000000ULL * 1000000ULL;   // MHz 단위로 내림
+    }
+    return step_hz;
+}
+
 // OpenGL 관련
 static GLFWwindow* window = nullptr;
 static int window_width = 1920;
 static int window_height = 1080;
 
+// 정적 레이어(그리드, 축 라벨) 캐시 - 범위나 dB 한계가 바뀔 때만 재생성
+struct StaticLayerCache {
+    GLuint list = 0;
+    bool valid = false;
+    uint64_t start_freq = 0;
+    uint64_t end_freq = 0;
+    float db_min = 0.0f;
+    float db_max = 0.0f;
+};
+
+static StaticLayerCache static_layer;
+
+// 렌더 스레드 깨우기 (새 데이터 도착 알림, 어느 스레드에서든 호출 가능)
+void notify_render() {
+    wideband_state.data_generation++;
+    glfwPostEmptyEvent();
+}
+
 // ==================== 색상 맵 ====================
 void value_to_color(float value, float min_val, float max_val, float& r, float& g, float& b) {
     float normalized = (value - min_val) / (max_val - min_val);
@@ -145,50 +211,243 @@ void draw_text_gl(float x, float y, const char* text) {
 }
 
 // ==================== FFT 처리 ====================
-void process_fft(const int16_t* iq_data, std::vector<float>& fft_result) {
-    // IQ 데이터를 복소수로 변환하고 윈도우 적용
-    for (int i = 0; i < FFT_SIZE; i++) {
-        float i_val = iq_data[2 * i] / 2048.0f;  // Q11 → 정규화
-        float q_val = iq_data[2 * i + 1] / 2048.0f;
-        wideband_state.fft_in[i][0] = i_val * wideband_state.window[i];
-        wideband_state.fft_in[i][1] = q_val * wideband_state.window[i];
+// fft_result: fft_size개의 dBFS 값 (DC가 중앙에 오도록 shift된 순서로 기록)
+// iq_data: FFT 프런트엔드는 fft_size, PFB는 PFB_TAPS * fft_size 샘플
+void process_fft(const int16_t* iq_data, float* fft_result) {
+    const int fft_size = wideband_state.fft.size();
+    compute_spectrum(wideband_state.fft, wideband_state.frontend == FRONTEND_PFB, iq_data, fft_result);
+    apply_dc_handling(fft_result, fft_size, wideband_state.dc_mode.load(),
+                      dc_half_width_bins(DC_NOTCH_HZ, fft_size, SAMPLE_RATE));
+}
+
+// 요청된 FFT 크기/윈도우/프런트엔드 적용 (스윕 경계에서 호출)
+// 플랜과 윈도우는 캐시에서 가져오므로 재플래닝 없음. 크기가 바뀌면 true
+bool apply_fft_config(SweepArena& arena) {
+    int size = wideband_state.requested_fft_size.load();
+    WindowType type = (WindowType)wideband_state.requested_window_type.load();
+    FrontEnd frontend = (FrontEnd)wideband_state.requested_frontend.load();
+    if (size == wideband_state.fft_size && type == wideband_state.window_type &&
+        frontend == wideband_state.frontend) {
+        return false;
     }
     
-    // FFT 수행
-    fftw_execute(wideband_state.fft_plan);
+    bool size_changed = size != wideband_state.fft_size;
+    wideband_state.fft = wideband_state.fft_cache.get(size, type);
+    if (size_changed) {
+        configure_sweep_arena(arena, size, wideband_state.spectrum_bins_for(size));
+    }
     
-    // 파워 스펙트럼 계산 (dBFS)
-    fft_result.resize(FFT_SIZE);
+    {
+        std::lock_guard<std::mutex> lock(wideband_state.mutex);
+        wideband_state.window_type = type;
+        wideband_state.frontend = frontend;
+        if (size_changed) {
+            wideband_state.fft_size = size;
+            wideband_state.configure_spectrum(size);
+        }
+    }
+    notify_render();
     
-    // 윈도우 보정 계산
-    float window_power_sum = 0.0f;
-    for (int i = 0; i < FFT_SIZE; i++) {
-        window_power_sum += wideband_state.window[i] * wideband_state.window[i];
+    printf("✓ FFT 설정 변경: %d점 (RBW %.2f kHz), %s 윈도우, %s 프런트엔드 (스텝 %llu MHz)\n",
+           size, (double)SAMPLE_RATE / size / 1000.0, window_type_name(type),
+           frontend_name(frontend), (unsigned long long)(capture_step_hz(frontend) / 1000000));
+    return size_changed;
+}
+
+// ==================== 프런트엔드 벤치마크 ====================
+// --bench: 하드웨어 없이 합성 IQ로 Hann FFT와 PFB 채널라이저의 처리량,
+// 스캘럽 손실(빈 중심 vs 빈 경계 톤), 스윕당 예상 시간(튜닝 횟수 × (정착 + 캡처 + 처리))을 비교
+
+// 톤(tone_bin 위치, 빈 단위) + 약한 잡음 (결정적 LCG)
+void fill_test_iq(int16_t* iq, int samples, int fft_size, double tone_bin) {
+    uint32_t lcg = 12345;
+    for (int n = 0; n < samples; n++) {
+        double phase = 2.0 * M_PI * tone_bin * n / fft_size;
+        lcg = lcg * 1664525u + 1013904223u;
+        int noise_i = (int)(lcg >> 28) - 8;
+        lcg = lcg * 1664525u + 1013904223u;
+        int noise_q = (int)(lcg >> 28) - 8;
+        iq[2 * n] = (int16_t)(1024.0 * cos(phase)) + noise_i;
+        iq[2 * n + 1] = (int16_t)(1024.0 * sin(phase)) + noise_q;
+    }
+}
+
+float peak_of(const float* spectrum, int size) {
+    float peak = -300.0f;
+    for (int i = 0; i < size; i++) {
+        if (spectrum[i] > peak) peak = spectrum[i];
     }
-    float window_correction = 10.0f * log10f(window_power_sum / FFT_SIZE);
+    return peak;
+}
+
+int run_frontend_benchmark() {
+    printf("📏 프런트엔드 벤치마크 (합성 IQ, Hann 윈도우, PFB %d탭)\n", PFB_TAPS);
+    printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
+    printf("  FFT 크기  프런트엔드   μs/스펙트럼   입력 MS/s   실시간 배수   스캘럽 손실\n");
     
-    for (int i = 0; i < FFT_SIZE; i++) {
-        float real = wideband_state.fft_out[i][0];
-        float imag = wideband_state.fft_out[i][1];
-        float power = (real * real + imag * imag) / (FFT_SIZE * FFT_SIZE);
-        
-        // dBFS로 변환 (Full Scale 기준)
-        float db = 10.0f * log10f(power + 1e-20f);
+    const int sizes[] = { MIN_FFT_SIZE, DEFAULT_FFT_SIZE, MAX_FFT_SIZE };
+    double default_us_per_spectrum[FRONTEND_COUNT] = {};
+    for (int size : sizes) {
+        std::vector<int16_t> iq((size_t)size * PFB_TAPS * 2);
+        std::vector<float> spectrum(size);
         
-        // 윈도우 손실 보정
-        db -= window_correction;
-        
-        fft_result[i] = db;
+        for (int frontend = 0; frontend < FRONTEND_COUNT; frontend++) {
+            wideband_state.frontend = (FrontEnd)frontend;
+            wideband_state.fft = wideband_state.fft_cache.get(size, WINDOW_HANN);
+            int samples = samples_per_spectrum(frontend, size);
+            
+            // 스캘럽 손실: 빈 중심 톤과 빈 경계(+0.5빈) 톤의 피크 차이
+            fill_test_iq(iq.data(), samples, size, size / 8.0);
+            process_fft(iq.data(), spectrum.data());
+            float peak_center = peak_of(spectrum.data(), size);
+            fill_test_iq(iq.data(), samples, size, size / 8.0 + 0.5);
+            process_fft(iq.data(), spectrum.data());
+            float peak_edge = peak_of(spectrum.data(), size);
+            
+            // 처리량 (약 2^25 입력 샘플 분량)
+            int iterations = (1 << 25) / samples;
+            if (iterations < 8) iterations = 8;
+            auto t0 = std::chrono::steady_clock::now();
+            for (int it = 0; it < iterations; it++) {
+                process_fft(iq.data(), spectrum.data());
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(t1 - t0).count();
+            double us_per_spectrum = seconds * 1e6 / iterations;
+            double input_msps = (double)samples * iterations / seconds / 1e6;
+            if (size == DEFAULT_FFT_SIZE) default_us_per_spectrum[frontend] = us_per_spectrum;
+            
+            printf("  %8d  %-10s  %11.1f  %10.1f  %11.2fx  %9.2f dB\n",
+                   size, frontend_name(frontend), us_per_spectrum, input_msps,
+                   input_msps * 1e6 / SAMPLE_RATE, peak_center - peak_edge);
+        }
     }
     
-    // FFT shift (DC를 중앙으로)
-    std::vector<float> shifted(FFT_SIZE);
-    int half = FFT_SIZE / 2;
-    for (int i = 0; i < half; i++) {
-        shifted[i] = fft_result[i + half];
-        shifted[i + half] = fft_result[i];
+    // 스윕당 예상 시간 (70 MHz ~ 6 GHz 전체 범위, 기본 FFT 크기)
+    // 방문 한 번 = 정착 + 캡처((taps + 체류 - 1) × FFT 크기 샘플) + 체류 프레임 처리 (순차 실행)
+    // bladerf_set_frequency 호출 자체의 시간은 하드웨어 없이는 알 수 없어 제외
+    uint64_t span = 6000000000ULL - 70000000ULL;
+    printf("\n  70 MHz ~ 6 GHz 스윕당 예상 시간 (FFT %d점, 정착 %d μs, 튜닝 명령 시간 제외)\n",
+           DEFAULT_FFT_SIZE, RETUNE_SETTLE_US);
+    printf("  프런트엔드  스텝     튜닝  체류   캡처 샘플    캡처 μs    처리 μs   스윕 시간\n");
+    for (int frontend = 0; frontend < FRONTEND_COUNT; frontend++) {
+        uint64_t step_hz = capture_step_hz(frontend);
+        uint64_t retunes = span / step_hz + 1;
+        const int dwells[] = { 1, MAX_DWELL_CHUNKS };
+        for (int dwell : dwells) {
+            int samples = capture_samples(frontend, DEFAULT_FFT_SIZE, dwell);
+            double capture_us = samples * 1e6 / SAMPLE_RATE;
+            double process_us = dwell * default_us_per_spectrum[frontend];
+            double sweep_s = retunes * (RETUNE_SETTLE_US + capture_us + process_us) / 1e6;
+            printf("  %-10s  %2llu MHz  %4llu  %4d  %10d  %9.1f  %9.1f  %8.2f s\n",
+                   frontend_name(frontend), (unsigned long long)(step_hz / 1000000),
+                   (unsigned long long)retunes, dwell, samples, capture_us, process_us, sweep_s);
+        }
+    }
+    printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
+    return 0;
+}
+
+// ==================== 점유율 통계 ====================
+double wall_clock_seconds() {
+    using namespace std::chrono;
+    return duration<double>(system_clock::now().time_since_epoch()).count();
+}
+
+void occupancy_checkpoint_path(int fft_size, char* path, size_t len) {
+    snprintf(path, len, OCCUPANCY_CHECKPOINT_FMT, fft_size);
+}
+
+// 현재 FFT 크기의 스티칭 배열에 맞춰 통계 엔진 구성, 일치하는 체크포인트가 있으면 복원
+// 체크포인트 writer의 스냅샷 버퍼도 새 크기로 할당 (정상 상태 저장은 복사만)
+void configure_occupancy(OccupancyStats& occupancy, OccupancyCheckpointWriter& writer) {
+    OccupancyConfig config;
+    config.duty_threshold_db = OCCUPANCY_THRESHOLD_DB;
+    occupancy.configure(wideband_state.full_spectrum.size(), wideband_state.array_start_hz(),
+                        wideband_state.hz_per_array_bin(), config);
+    
+    char path[256];
+    occupancy_checkpoint_path(wideband_state.fft_size, path, sizeof(path));
+    if (occupancy.load_checkpoint(path)) {
+        printf("✓ 점유율 통계 복원: %s (스윕 %llu회, 에포크 %d개)\n",
+               path, (unsigned long long)occupancy.sweeps(), occupancy.epoch_count());
+    }
+    writer.prepare(occupancy);
+}
+
+// 스냅샷 복사 후 백그라운드 저장 (파일 쓰기는 writer 스레드, 실패는 writer가 출력)
+// wait=true: 이전 쓰기가 끝날 때까지 기다렸다가 반드시 요청 (구성 전환/종료)
+// wait=false: 이전 쓰기가 아직 진행 중이면 이번 주기는 건너뛰고 false
+bool save_occupancy(const OccupancyStats& occupancy, OccupancyCheckpointWriter& writer, bool wait) {
+    if (occupancy.sweeps() == 0) return true;
+    
+    char path[256];
+    occupancy_checkpoint_path(wideband_state.fft_size, path, sizeof(path));
+    if (wait) writer.wait();
+    return writer.submit(occupancy, path);
+}
+
+// 표시 범위를 그리드와 같은 10개 구간으로 나눠 전체 기간 / 최근 1시간 점유율 출력
+void print_occupancy_report(const OccupancyStats& occupancy) {
+    double now = wall_clock_seconds();
+    double start = (double)wideband_state.start_freq;
+    double span = (double)(wideband_state.end_freq - wideband_state.start_freq) / 10.0;
+    
+    printf("\n📊 점유율 보고 (임계값 %.0f dBFS, 스윕 %llu회, %.1f시간)\n",
+           occupancy.config().duty_threshold_db, (unsigned long long)occupancy.sweeps(),
+           (occupancy.last_time() - occupancy.first_time()) / 3600.0);
+    printf("  구간(MHz)          Min    Mean    Max    P50    P90   Duty  Duty(1h)\n");
+    for (int i = 0; i < 10; i++) {
+        double f_lo = start + span * i;
+        double f_hi = f_lo + span;
+        OccupancySummary all = occupancy.query(f_lo, f_hi);
+        OccupancySummary hour = occupancy.query_window(f_lo, f_hi, now - 3600.0, now);
+        printf("  %7.2f~%7.2f  %6.1f %6.1f %6.1f %6.1f %6.1f %5.1f%% %6.1f%%\n",
+               f_lo / 1e6, f_hi / 1e6, all.min_db, all.mean_db, all.max_db,
+               occupancy.percentile(f_lo, f_hi, 50.0f), occupancy.percentile(f_lo, f_hi, 90.0f),
+               all.duty * 100.0f, hour.duty * 100.0f);
+    }
+    printf("\n");
+}
+
+// ==================== 스펙트럼 게시 ====================
+// 최대 FFT 크기 기준으로 세그먼트를 한 번만 만들어 RBW를 바꿔도 reader가 다시 열 필요 없음
+void open_spectrum_shm(SpectrumShmWriter& shm) {
+    uint32_t max_bins = (uint32_t)wideband_state.spectrum_bins_for(MAX_FFT_SIZE);
+    if (!shm.open(SPECTRUM_SHM_NAME, SPECTRUM_SHM_SLOTS, max_bins,
+                  wideband_state.start_freq, wideband_state.end_freq, SAMPLE_RATE)) {
+        if (errno == EBUSY) {
+            fprintf(stderr, "⚠ 스펙트럼 공유 메모리: 다른 writer 프로세스가 %s 게시 중 — 게시 안 함\n",
+                    SPECTRUM_SHM_NAME);
+        } else {
+            fprintf(stderr, "⚠ 스펙트럼 공유 메모리 생성 실패: %s (%s)\n",
+                    SPECTRUM_SHM_NAME, strerror(errno));
+        }
+        return;
     }
-    fft_result = shifted;
+    printf("✓ 스펙트럼 게시: /dev/shm%s (슬롯 %d개, 최대 %u빈, %.1f MB)\n",
+           SPECTRUM_SHM_NAME, SPECTRUM_SHM_SLOTS, max_bins,
+           spectrum_shm_total_size(SPECTRUM_SHM_SLOTS, max_bins) / 1e6);
+}
+
+// 완료된 스윕 게시 (잠금/할당 없음, full_spectrum은 이 스레드만 씀)
+// measured: 이번 스윕에서 실제로 기록된 빈 (first/last 사이의 채움값 구분용)
+void publish_spectrum(SpectrumShmWriter& shm, const uint8_t* measured,
+                      size_t first_index, size_t last_index, double now) {
+    if (!shm.is_open()) return;
+    
+    SpectrumSweepInfo info = {};
+    info.sweep_count = (uint64_t)wideband_state.sweep_count;
+    info.timestamp = now;
+    info.start_hz = wideband_state.array_start_hz();
+    info.hz_per_bin = wideband_state.hz_per_array_bin();
+    info.fft_size = (uint32_t)wideband_state.fft_size;
+    info.window_type = (uint32_t)wideband_state.window_type;
+    info.frontend = (uint32_t)wideband_state.frontend;
+    info.first_bin = (uint32_t)first_index;
+    info.last_bin = (uint32_t)last_index;
+    shm.publish(info, wideband_state.full_spectrum.data(), measured,
+                (uint32_t)wideband_state.full_spectrum.size());
 }
 
 // ==================== BladeRF 스윕 스레드 ====================
@@ -229,6 +488,11 @@ void bladerf_sweep_thread() {
         return;
     }
     printf("✓ 대역폭: %.2f MHz\n", actual_bw / 1e6);
+    wideband_state.analog_bandwidth = actual_bw;
+    if (capture_step_hz(FRONTEND_PFB) < PFB_STEP_SIZE_MHZ * 1000000ULL) {
+        printf("  PFB 스텝 %llu MHz로 제한 (아날로그 대역폭 - %d MHz)\n",
+               (unsigned long long)(capture_step_hz(FRONTEND_PFB) / 1000000), ANALOG_EDGE_MARGIN_MHZ);
+    }
     
     // 게인 설정
     status = bladerf_set_gain_mode(dev, CHANNEL, BLADERF_GAIN_MANUAL);
@@ -270,52 +534,152 @@ void bladerf_sweep_thread() {
     
     usleep(200000);
     
-    // IQ 버퍼
-    std::vector<int16_t> iq_buffer(FFT_SIZE * 2 * wideband_state.num_chunks);
-    std::vector<float> fft_result;
+    // 작업 버퍼 (최대 체류 시간 기준, 한 번만 할당)
+    SweepArena arena;
+    configure_sweep_arena(arena, wideband_state.fft_size,
+                          wideband_state.spectrum_bins_for(wideband_state.fft_size));
+    
+    // RBW 전환이 즉시 이루어지도록 모든 FFT 크기/윈도우 조합을 미리 생성
+    wideband_state.fft_cache.prewarm(MIN_FFT_SIZE, MAX_FFT_SIZE);
+    printf("✓ FFT 플랜 캐시: 플랜 %zu개, 윈도우 %zu개 (%d ~ %d점)\n",
+           wideband_state.fft_cache.num_plans(), wideband_state.fft_cache.num_windows(),
+           MIN_FFT_SIZE, MAX_FFT_SIZE);
+    
+    // 적응형 스케줄러: 스텝 = start_freq부터 프런트엔드별 스텝 간격의 중심 주파수
+    // (프런트엔드가 바뀌어 스텝 간격이 달라지면 스윕 루프에서 재구성)
+    uint64_t step_hz = capture_step_hz(wideband_state.frontend);
+    int num_steps = (int)((wideband_state.end_freq - wideband_state.start_freq) / step_hz) + 1;
+    SweepSchedulerConfig scheduler_config;
+    scheduler_config.min_dwell_chunks = wideband_state.num_chunks;
+    scheduler_config.max_dwell_chunks = MAX_DWELL_CHUNKS;
+    SweepScheduler scheduler;
+    scheduler.configure(num_steps, scheduler_config);
     
     printf("\n📡 스펙트럼 스윕 시작...\n");
     printf("  범위: %llu MHz ~ %llu MHz\n", 
            wideband_state.start_freq / 1000000,
            wideband_state.end_freq / 1000000);
-    printf("  FFT 크기: %d\n", FFT_SIZE);
-    printf("  청크 수: %d\n", wideband_state.num_chunks);
+    printf("  FFT 크기: %d (RBW %.2f kHz)\n", wideband_state.fft_size,
+           (double)SAMPLE_RATE / wideband_state.fft_size / 1000.0);
+    printf("  청크 수: %d ~ %d (활동도에 따라)\n", wideband_state.num_chunks, MAX_DWELL_CHUNKS);
+    printf("  스텝 수: %d (재방문 간격 최대 %llu 슬롯)\n",
+           num_steps, (unsigned long long)scheduler.revisit_bound());
     printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
     printf("키 바인딩:\n");
     printf("  F        : dB 범위 조정 모드 토글\n");
     printf("  ↑/↓      : dB 최댓값 조정 (F 모드 시)\n");
     printf("  ←/→      : dB 최솟값 조정 (F 모드 시)\n");
     printf("  R        : dB 범위 리셋\n");
+    printf("  [ / ]    : FFT 크기 절반/두 배 (RBW 전환)\n");
+    printf("  W        : 윈도우 종류 변경\n");
+    printf("  O        : 점유율 보고 출력\n");
+    printf("  P        : 프런트엔드 전환 (Hann FFT / PFB 채널라이저)\n");
+    printf("  D        : DC 빈 처리 변경 (keep / interp / floor)\n");
     printf("  ESC      : 종료\n");
     printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n");
     
+    // 장기 점유율 통계
+    OccupancyStats occupancy;
+    OccupancyCheckpointWriter checkpoint_writer;
+    configure_occupancy(occupancy, checkpoint_writer);
+    double last_checkpoint_time = wall_clock_seconds();
+    
+    // 로컬 소비자용 스펙트럼 게시
+    SpectrumShmWriter shm;
+    open_spectrum_shm(shm);
+    
+    // 워밍업 이후 스윕 스레드의 힙 할당 감시
+    int warmup_sweeps_left = ALLOC_WARMUP_SWEEPS;
+    bool device_allocs_reported = false;
+    
+    // 스케줄러 잡음 기준선을 측정한 구성 (FFT 크기/윈도우/프런트엔드/DC 처리 중 하나라도 바뀌면 재측정)
+    int baseline_fft_size = 0;
+    int baseline_window = -1;
+    int baseline_frontend = -1;
+    int baseline_dc_mode = -1;
+    
     // 메인 스윕 루프
     while (wideband_state.running) {
+        // RBW/윈도우 변경 요청 적용 (크기가 바뀌면 버퍼 재할당 → 워밍업 다시 시작)
+        // 빈 구성이 바뀌므로 점유율 통계는 현재 크기 체크포인트에 저장 후 새 크기로 전환
+        if (wideband_state.requested_fft_size.load() != wideband_state.fft_size) {
+            save_occupancy(occupancy, checkpoint_writer, true);
+        }
+        if (apply_fft_config(arena)) {
+            configure_occupancy(occupancy, checkpoint_writer);
+            warmup_sweeps_left = ALLOC_WARMUP_SWEEPS;
+        }
+        const int fft_size = wideband_state.fft_size;
+        const int spectrum_samples = samples_per_spectrum(wideband_state.frontend, fft_size);
+        
+        // 프런트엔드가 바뀌어 스텝 간격이 달라졌으면 스케줄러 재구성
+        if (capture_step_hz(wideband_state.frontend) != step_hz) {
+            step_hz = capture_step_hz(wideband_state.frontend);
+            num_steps = (int)((wideband_state.end_freq - wideband_state.start_freq) / step_hz) + 1;
+            scheduler.configure(num_steps, scheduler_config);
+            baseline_fft_size = 0;
+            warmup_sweeps_left = ALLOC_WARMUP_SWEEPS;
+            printf("✓ 스텝 %llu MHz, 스텝 수 %d\n",
+                   (unsigned long long)(step_hz / 1000000), num_steps);
+        }
+        
+        const StitchRange range = stitch_range(fft_size, SAMPLE_RATE, step_hz);
+        const int dc_half_width = dc_half_width_bins(DC_NOTCH_HZ, fft_size, SAMPLE_RATE);
+        
+        // 잡음만 있는 스텝의 분산/피크를 같은 처리 경로로 측정 → 이를 넘는 만큼만 활동 점수
+        const int dc_mode = wideband_state.dc_mode.load();
+        if (fft_size != baseline_fft_size || wideband_state.window_type != baseline_window ||
+            wideband_state.frontend != baseline_frontend || dc_mode != baseline_dc_mode) {
+            calibrate_noise_baseline(scheduler, wideband_state.fft, wideband_state.frontend == FRONTEND_PFB,
+                                     dc_mode, dc_half_width, range, fft_size, spectrum_samples, arena);
+            baseline_fft_size = fft_size;
+            baseline_window = wideband_state.window_type;
+            baseline_frontend = wideband_state.frontend;
+            baseline_dc_mode = dc_mode;
+            printf("✓ 잡음 기준선 (체류 %d / %d): 분산 %.1f / %.1f dB², 피크 +%.1f / +%.1f dB\n",
+                   scheduler_config.min_dwell_chunks, MAX_DWELL_CHUNKS,
+                   scheduler.noise_variance(scheduler_config.min_dwell_chunks),
+                   scheduler.noise_variance(MAX_DWELL_CHUNKS),
+                   scheduler.noise_peak_excess(scheduler_config.min_dwell_chunks),
+                   scheduler.noise_peak_excess(MAX_DWELL_CHUNKS));
+        }
+        
         wideband_state.sweep_count++;
+        uint64_t allocs_at_sweep_start = alloc_counter::thread_allocations();
+        uint64_t device_allocs = 0;   // libbladeRF/libusb 호출 안의 할당 (따로 집계)
         
-        uint64_t freq = wideband_state.start_freq;
         int step_count = 0;
+        scheduler.begin_sweep();
+        
+        // 이번 스윕에 기록된 스티칭 배열 범위와 빈별 기록 여부 (점유율 통계 반영용)
+        size_t sweep_first_index = SIZE_MAX;
+        size_t sweep_last_index = 0;
+        std::fill(arena.measured.begin(), arena.measured.end(), 0);
         
         printf("\n=== SWEEP #%d START ===\n", wideband_state.sweep_count);
         
         // 🔴 새 스윕 시작: 스펙트럼 데이터 초기화 (과거 주파수 데이터 제거)
         {
             std::lock_guard<std::mutex> lock(wideband_state.mutex);
-            std::fill(wideband_state.full_spectrum.begin(), 
-                     wideband_state.full_spectrum.end(), -80.0f);
-            std::fill(wideband_state.peak_spectrum.begin(), 
-                     wideband_state.peak_spectrum.end(), -120.0f);
-            std::fill(wideband_state.avg_spectrum_acc.begin(), 
-                     wideband_state.avg_spectrum_acc.end(), -80.0f);
-            wideband_state.waterfall_history.clear();
+            wideband_state.clear_sweep();
         }
+        notify_render();
         printf("✓ 스펙트럼 데이터 초기화 완료 (과거 데이터 제거)\n");
         
-        while (freq <= wideband_state.end_freq && wideband_state.running) {
+        // 모든 스텝을 한 번 이상 방문하면 스윕 완료 (활동 많은 스텝은 그 사이 재방문)
+        // FFT 설정 변경 요청이 있으면 스윕을 중단하고 바로 적용
+        while (!scheduler.coverage_complete() && wideband_state.running &&
+               !wideband_state.fft_config_pending()) {
             step_count++;
             
+            SweepVisit visit = scheduler.next();
+            uint64_t freq = wideband_state.start_freq + visit.step * step_hz;
+            int dwell_chunks = visit.dwell_chunks;
+            
             // 주파수 설정
+            uint64_t allocs_before_device = alloc_counter::thread_allocations();
             status = bladerf_set_frequency(dev, CHANNEL, freq);
+            device_allocs += alloc_counter::thread_allocations() - allocs_before_device;
             if (status != 0) {
                 fprintf(stderr, "\n❌ 주파수 설정 실패: %s\n", bladerf_strerror(status));
                 break;
@@ -324,121 +688,68 @@ void bladerf_sweep_thread() {
             wideband_state.current_freq = freq;
             
             // 정착 시간
-            usleep(1000);
+            usleep(RETUNE_SETTLE_US);
             
-            // 여러 청크 수집 및 평균화
-            std::vector<float> avg_spectrum(FFT_SIZE, 0.0f);
-            
-            for (int chunk = 0; chunk < wideband_state.num_chunks; chunk++) {
-                // IQ 데이터 수신
-                status = bladerf_sync_rx(dev, iq_buffer.data() + (chunk * FFT_SIZE * 2),
-                                        FFT_SIZE, nullptr, 5000);
-                if (status != 0) {
-                    fprintf(stderr, "\n❌ RX 오류: %s\n", bladerf_strerror(status));
-                    break;
-                }
-                
-                // FFT 처리
-                process_fft(iq_buffer.data() + (chunk * FFT_SIZE * 2), fft_result);
-                
-                // 누적
-                for (size_t i = 0; i < fft_result.size(); i++) {
-                    avg_spectrum[i] += fft_result[i];
-                }
+            // 체류 프레임 전체를 한 번에 수신 (프레임 간격 fft_size, PFB 프레임은 겹침)
+            int capture = capture_samples(wideband_state.frontend, fft_size, dwell_chunks);
+            allocs_before_device = alloc_counter::thread_allocations();
+            status = bladerf_sync_rx(dev, arena.iq_buffer.data(), capture, nullptr, 5000);
+            device_allocs += alloc_counter::thread_allocations() - allocs_before_device;
+            if (status != 0) {
+                fprintf(stderr, "\n❌ RX 오류: %s\n", bladerf_strerror(status));
+                continue;
             }
             
-            // 평균 계산
-            for (size_t i = 0; i < avg_spectrum.size(); i++) {
-                avg_spectrum[i] /= wideband_state.num_chunks;
-            }
+            // FFT 처리 및 평균화
+            average_frames(wideband_state.fft, wideband_state.frontend == FRONTEND_PFB,
+                           wideband_state.dc_mode.load(), dc_half_width,
+                           arena.iq_buffer.data(), fft_size, dwell_chunks,
+                           arena.fft_result.data(), arena.avg_spectrum.data());
             
-            // 디버그: 평균 파워 출력
-            float avg_power = 0.0f;
-            float max_power = -200.0f;
-            float min_power = 200.0f;
-            for (size_t i = 0; i < avg_spectrum.size(); i++) {
-                avg_power += avg_spectrum[i];
-                if (avg_spectrum[i] > max_power) max_power = avg_spectrum[i];
-                if (avg_spectrum[i] < min_power) min_power = avg_spectrum[i];
-            }
-            avg_power /= avg_spectrum.size();
+            // 스티칭되는 빈만의 통계 → 스케줄러 활동 점수
+            StepStats stats = measure_step(arena.avg_spectrum.data(), range);
+            StepActivity activity;
+            activity.mean_db = stats.mean_db;
+            activity.peak_db = stats.max_db;
+            activity.variance_db = stats.variance_db;
+            activity.dwell_chunks = dwell_chunks;
+            scheduler.report(visit.step, activity);
             
-            printf("Step %d: Freq=%llu MHz, Min=%.1f, Avg=%.1f, Max=%.1f dB\n", 
-                   step_count, freq / 1000000, min_power, avg_power, max_power);
+            printf("Step %d [#%d%s]: Freq=%llu MHz, Min=%.1f, Avg=%.1f, Max=%.1f dB, Dwell=%d, Score=%.2f\n", 
+                   step_count, visit.step, visit.forced ? " forced" : "", freq / 1000000,
+                   stats.min_db, stats.mean_db, stats.max_db, dwell_chunks, scheduler.score(visit.step));
             
-            // 전체 스펙트럼 범위 계산
-            uint64_t total_range = wideband_state.end_freq - wideband_state.start_freq;
-            uint64_t extended_range = total_range + SAMPLE_RATE;  // 양쪽 확장
+            // 전체 스펙트럼 배열의 주파수 축 (게시/점유율 통계와 같은 축)
             size_t total_bins = wideband_state.full_spectrum.size();
-            
-            // 배열 시작 주파수 = start_freq - SAMPLE_RATE/2
-            uint64_t array_start_freq = wideband_state.start_freq - SAMPLE_RATE/2;
-            
-            // 현재 주파수의 시작 위치 계산
-            int64_t freq_offset = (int64_t)freq - (int64_t)array_start_freq;
-            size_t base_index = (size_t)((double)freq_offset / (double)extended_range * (double)total_bins);
-            
-            // FFT 결과의 각 빈을 전체 스펙트럼에 매핑
-            double hz_per_bin = (double)SAMPLE_RATE / (double)FFT_SIZE;
-            double bins_per_mhz = (double)total_bins / (double)(extended_range / 1000000);
+            double array_start_hz = wideband_state.array_start_hz();
+            double hz_per_array_bin = wideband_state.hz_per_array_bin();
             
             // 🔴 디버그: 매핑 정보 출력
-            printf("  -> base_index=%zu, total_bins=%zu, bins_per_mhz=%.2f\n",
-                   base_index, total_bins, bins_per_mhz);
+            printf("  -> center_index=%.1f, total_bins=%zu, bins_per_mhz=%.2f\n",
+                   ((double)freq - array_start_hz) / hz_per_array_bin, total_bins, 1e6 / hz_per_array_bin);
             printf("  -> FFT covers: %.1f ~ %.1f MHz\n",
                    (freq - SAMPLE_RATE/2) / 1e6, (freq + SAMPLE_RATE/2) / 1e6);
             printf("  -> Array covers: %.1f ~ %.1f MHz\n",
-                   array_start_freq / 1e6, (array_start_freq + extended_range) / 1e6);
-            
-            size_t min_written_index = total_bins;
-            size_t max_written_index = 0;
-            size_t num_written = 0;
+                   array_start_hz / 1e6, (array_start_hz + total_bins * hz_per_array_bin) / 1e6);
             
+            // FFT 결과의 각 빈을 전체 스펙트럼에 매핑
+            StitchResult written;
             {
                 std::lock_guard<std::mutex> lock(wideband_state.mutex);
-                
-                // 사용할 FFT 범위: 중심에서 ±STEP_SIZE/2 만 사용
-                uint64_t use_range = (STEP_SIZE_MHZ * 1000000ULL) / 2;
-                
-                for (size_t i = 0; i < avg_spectrum.size(); i++) {
-                    // FFT 빈 i가 나타내는 주파수 오프셋 (중심 주파수 기준)
-                    double freq_offset_hz = (i - FFT_SIZE / 2.0) * hz_per_bin;
-                    
-                    // 중심 주파수로부터 너무 멀면 건너뛰기
-                    if (fabs(freq_offset_hz) > use_range) continue;
-                    
-                    double freq_offset_mhz = freq_offset_hz / 1000000.0;
-                    int64_t global_index = base_index + (int64_t)(freq_offset_mhz * bins_per_mhz);
-                    
-                    if (global_index >= 0 && global_index < (int64_t)total_bins) {
-                        num_written++;
-                        if ((size_t)global_index < min_written_index) min_written_index = global_index;
-                        if ((size_t)global_index > max_written_index) max_written_index = global_index;
-                        
-                        float new_value = avg_spectrum[i];
-                        
-                        // 직접 덮어쓰기 (블렌딩 없음)
-                        wideband_state.avg_spectrum_acc[global_index] = new_value;
-                        wideband_state.full_spectrum[global_index] = new_value;
-                        
-                        if (wideband_state.peak_hold_enabled) {
-                            if (new_value > wideband_state.peak_spectrum[global_index]) {
-                                wideband_state.peak_spectrum[global_index] = new_value;
-                            } else {
-                                wideband_state.peak_spectrum[global_index] -= 0.05f;
-                            }
-                        }
-                    }
-                }
+                written = stitch_step(wideband_state, arena.measured.data(), arena.avg_spectrum.data(),
+                                      fft_size, range, freq, wideband_state.peak_hold_enabled);
             }
+            notify_render();
             
-            printf("  -> Written %zu bins: index %zu ~ %zu (%.1f ~ %.1f MHz)\n",
-                   num_written, min_written_index, max_written_index,
-                   (wideband_state.start_freq - SAMPLE_RATE/2)/1e6 + min_written_index/bins_per_mhz,
-                   (wideband_state.start_freq - SAMPLE_RATE/2)/1e6 + max_written_index/bins_per_mhz);
+            if (written.num_written > 0) {
+                if (written.first_index < sweep_first_index) sweep_first_index = written.first_index;
+                if (written.last_index > sweep_last_index) sweep_last_index = written.last_index;
+            }
             
-            // 다음 주파수로
-            freq += STEP_SIZE_MHZ * 1000000ULL;
+            printf("  -> Written %zu bins: index %zu ~ %zu (%.1f ~ %.1f MHz)\n",
+                   written.num_written, written.first_index, written.last_index,
+                   (array_start_hz + written.first_index * hz_per_array_bin) / 1e6,
+                   (array_start_hz + written.last_index * hz_per_array_bin) / 1e6);
         }
         
         // 워터폴에 추가
@@ -446,13 +757,51 @@ void bladerf_sweep_thread() {
             std::lock_guard<std::mutex> lock(wideband_state.mutex);
             wideband_state.add_waterfall_line();
         }
+        notify_render();
         printf("=== SWEEP #%d END ===\n", wideband_state.sweep_count);
+        
+        // 완료된 스윕만 점유율 통계에 반영 (full_spectrum은 이 스레드만 씀)
+        // 범위 안에서도 실제로 기록된 빈만 측정값으로 반영 (나머지는 초기화 채움값)
+        if (scheduler.coverage_complete() && sweep_first_index <= sweep_last_index) {
+            double now = wall_clock_seconds();
+            occupancy.update(wideband_state.full_spectrum.data(), arena.measured.data(),
+                             sweep_first_index, sweep_last_index, now);
+            publish_spectrum(shm, arena.measured.data(), sweep_first_index, sweep_last_index, now);
+            
+            if (now - last_checkpoint_time >= OCCUPANCY_CHECKPOINT_SEC &&
+                save_occupancy(occupancy, checkpoint_writer, false)) {
+                last_checkpoint_time = now;
+            }
+        }
+        if (wideband_state.occupancy_report_requested.exchange(false)) {
+            print_occupancy_report(occupancy);
+        }
+        
+        // 정상 상태 힙 할당 검사 (우리 코드 경로만, 장치 호출 안의 할당은 한 번 알림)
+        uint64_t sweep_allocs = alloc_counter::thread_allocations() - allocs_at_sweep_start - device_allocs;
+        if (warmup_sweeps_left > 0) {
+            warmup_sweeps_left--;
+        } else {
+            if (sweep_allocs > 0) {
+                fprintf(stderr, "⚠ 스윕 #%d: 정상 상태 힙 할당 %llu회 발생\n",
+                        wideband_state.sweep_count, (unsigned long long)sweep_allocs);
+                if (ALLOC_CHECK_ABORT) abort();
+            }
+            if (device_allocs > 0 && !device_allocs_reported) {
+                printf("  (libbladeRF/libusb 호출 안의 힙 할당 %llu회/스윕 — 검사에서 제외)\n",
+                       (unsigned long long)device_allocs);
+                device_allocs_reported = true;
+            }
+        }
         printf("  다음 스윕에서는 현재 주파수 범위(%llu~%llu MHz)만 표시됩니다\n\n",
                wideband_state.start_freq / 1000000,
                wideband_state.end_freq / 1000000);
     }
     
-    // 정리
+    // 정리 (마지막 체크포인트 쓰기가 끝날 때까지 대기)
+    save_occupancy(occupancy, checkpoint_writer, true);
+    checkpoint_writer.stop();
+    shm.close();
     bladerf_enable_module(dev, CHANNEL, false);
     bladerf_close(dev);
     
@@ -460,26 +809,14 @@ void bladerf_sweep_thread() {
 }
 
 // ==================== OpenGL 렌더링 ====================
-void render_spectrum() {
-    glClear(GL_COLOR_BUFFER_BIT);
-    
-    std::lock_guard<std::mutex> lock(wideband_state.mutex);
-    
-    size_t total_bins = wideband_state.full_spectrum.size();
-    if (total_bins == 0) return;
-    
-    float db_min = wideband_state.db_min;
-    float db_max = wideband_state.db_max;
-    
-    // 배열은 확장되어 있지만 표시는 start_freq ~ end_freq만
-    uint64_t display_range = wideband_state.end_freq - wideband_state.start_freq;
-    uint64_t array_range = display_range + SAMPLE_RATE;
+// 정적 레이어: 상/하단 그리드, dB/주파수 라벨, 중심 구분선
+// 매 프레임 40여 개의 glutBitmapCharacter 라벨을 다시 그리지 않도록 디스플레이 리스트로 컴파일
+void build_static_layer(uint64_t start_freq, uint64_t end_freq, float db_min, float db_max) {
+    if (static_layer.list == 0) {
+        static_layer.list = glGenLists(1);
+    }
     
-    // 배열에서 실제 표시할 범위의 시작/끝 인덱스 계산
-    size_t display_start_index = (size_t)(SAMPLE_RATE / 2.0 / array_range * total_bins);
-    size_t display_end_index = display_start_index + 
-                               (size_t)((double)display_range / array_range * total_bins);
-    size_t num_points = display_end_index - display_start_index;
+    glNewList(static_layer.list, GL_COMPILE);
     
     // ========== 상단: 파워 스펙트럼 (0.0 ~ 1.0) ==========
     
@@ -514,54 +851,16 @@ void render_spectrum() {
     }
     
     // 주파수 라벨 (하단)
-    uint64_t freq_range = wideband_state.end_freq - wideband_state.start_freq;
+    uint64_t freq_range = end_freq - start_freq;
     for (int i = 0; i <= 10; i++) {
         float x = -0.95f + 1.9f * i / 10.0f;
-        uint64_t freq_mhz = wideband_state.start_freq / 1000000 + 
+        uint64_t freq_mhz = start_freq / 1000000 + 
                            (freq_range / 1000000) * i / 10;
         char label[32];
         snprintf(label, sizeof(label), "%llu", freq_mhz);
         draw_text_gl(x - 0.03f, 0.01f, label);
     }
     
-    // 파워 스펙트럼 그리기
-    glColor3f(0.0f, 1.0f, 0.0f);
-    glLineWidth(1.5f);
-    glBegin(GL_LINE_STRIP);
-    
-    for (size_t i = 0; i < num_points; i++) {
-        float x = -0.95f + 1.9f * i / num_points;
-        float db = wideband_state.full_spectrum[display_start_index + i];
-        
-        // dB를 0.05 ~ 0.95로 매핑 (화면 상단)
-        float y = 0.05f + 0.9f * (db - db_min) / (db_max - db_min);
-        y = fmaxf(0.05f, fminf(0.95f, y));
-        
-        glVertex2f(x, y);
-    }
-    
-    glEnd();
-    
-    // Peak hold 그리기 (반투명 노란색)
-    if (wideband_state.peak_hold_enabled) {
-        glColor4f(1.0f, 1.0f, 0.0f, 0.6f);  // 노란색, 60% 투명도
-        glBegin(GL_LINE_STRIP);
-        
-        for (size_t i = 0; i < num_points; i++) {
-            float x = -0.95f + 1.9f * i / num_points;
-            float db = wideband_state.peak_spectrum[display_start_index + i];
-            
-            float y = 0.05f + 0.9f * (db - db_min) / (db_max - db_min);
-            y = fmaxf(0.05f, fminf(0.95f, y));
-            
-            glVertex2f(x, y);
-        }
-        
-        glEnd();
-    }
-    
-    glLineWidth(1.0f);
-    
     // 중심선 (구분선)
     glColor3f(0.8f, 0.8f, 0.8f);
     glLineWidth(2.0f);
@@ -597,62 +896,158 @@ void render_spectrum() {
     glColor3f(0.7f, 0.7f, 0.7f);
     for (int i = 0; i <= 10; i++) {
         float x = -0.95f + 1.9f * i / 10.0f;
-        uint64_t freq_mhz = wideband_state.start_freq / 1000000 + 
+        uint64_t freq_mhz = start_freq / 1000000 + 
                            (freq_range / 1000000) * i / 10;
         char label[32];
         snprintf(label, sizeof(label), "%llu", freq_mhz);
         draw_text_gl(x - 0.03f, -0.03f, label);
     }
     
-    // 워터폴 그리기 - 픽셀 기반
-    size_t history_size = wideband_state.waterfall_history.size();
-    if (history_size > 0) {
-        // 최신 데이터(index=history_size-1)가 위쪽, 오래된 데이터(index=0)가 아래쪽
-        for (size_t line = 0; line < history_size; line++) {
-            // 역순으로 접근: 가장 최신 데이터부터
-            size_t data_index = history_size - 1 - line;
-            const std::vector<float>& spectrum_line = wideband_state.waterfall_history[data_index];
-            if (spectrum_line.size() < display_end_index) continue;
+    glEndList();
+    
+    static_layer.start_freq = start_freq;
+    static_layer.end_freq = end_freq;
+    static_layer.db_min = db_min;
+    static_layer.db_max = db_max;
+    static_layer.valid = true;
+}
+
+// 타이틀이 실제로 바뀐 경우에만 glfwSetWindowTitle 호출
+void update_window_title(const char* title) {
+    static char last_title[256] = "";
+    if (strcmp(title, last_title) == 0) return;
+    snprintf(last_title, sizeof(last_title), "%s", title);
+    glfwSetWindowTitle(window, title);
+}
+
+// 렌더 스레드 전용 스냅샷 (그리기는 잠금 해제 후 스냅샷에서 수행)
+static RenderSnapshot render_snapshot;
+
+// 스냅샷 버퍼는 최대 FFT 크기 기준으로 한 번만 할당
+void configure_render_snapshot() {
+    configure_render_snapshot(render_snapshot, wideband_state.spectrum_bins_for(MAX_FFT_SIZE),
+                              WATERFALL_HISTORY);
+}
+
+// 표시 범위와 화면 설정을 스냅샷으로 복사 (mutex 보유 시간 = 복사 시간)
+bool take_render_snapshot(RenderSnapshot& snap) {
+    std::lock_guard<std::mutex> lock(wideband_state.mutex);
+    if (!snapshot_spectrum(wideband_state, wideband_state.peak_hold_enabled, snap)) return false;
+    
+    snap.db_min = wideband_state.db_min;
+    snap.db_max = wideband_state.db_max;
+    snap.adjust_mode = wideband_state.adjust_mode;
+    snap.current_freq = wideband_state.current_freq;
+    snap.sweep_count = wideband_state.sweep_count;
+    snap.fft_size = wideband_state.fft_size;
+    snap.window_type = wideband_state.window_type;
+    snap.frontend = wideband_state.frontend;
+    return true;
+}
+
+// title: 윈도우 타이틀 (그릴 데이터가 없으면 빈 문자열)
+void render_spectrum(char* title, size_t title_len) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    title[0] = '\0';
+    
+    RenderSnapshot& snap = render_snapshot;
+    if (!take_render_snapshot(snap)) return;
+    
+    // 이하 스윕 스레드와 경합 없음
+    float db_min = snap.db_min;
+    float db_max = snap.db_max;
+    size_t num_points = snap.num_points;
+    
+    // 범위나 dB 한계가 바뀌었을 때만 정적 레이어 재생성
+    if (!static_layer.valid ||
+        static_layer.start_freq != snap.start_freq ||
+        static_layer.end_freq != snap.end_freq ||
+        static_layer.db_min != db_min ||
+        static_layer.db_max != db_max) {
+        build_static_layer(snap.start_freq, snap.end_freq, db_min, db_max);
+    }
+    glCallList(static_layer.list);
+    
+    // 파워 스펙트럼 그리기
+    glColor3f(0.0f, 1.0f, 0.0f);
+    glLineWidth(1.5f);
+    glBegin(GL_LINE_STRIP);
+    
+    for (size_t i = 0; i < num_points; i++) {
+        float x = -0.95f + 1.9f * i / num_points;
+        float db = snap.spectrum[i];
+        
+        // dB를 0.05 ~ 0.95로 매핑 (화면 상단)
+        float y = 0.05f + 0.9f * (db - db_min) / (db_max - db_min);
+        y = fmaxf(0.05f, fminf(0.95f, y));
+        
+        glVertex2f(x, y);
+    }
+    
+    glEnd();
+    
+    // Peak hold 그리기 (반투명 노란색)
+    if (snap.peak_hold) {
+        glColor4f(1.0f, 1.0f, 0.0f, 0.6f);  // 노란색, 60% 투명도
+        glBegin(GL_LINE_STRIP);
+        
+        for (size_t i = 0; i < num_points; i++) {
+            float x = -0.95f + 1.9f * i / num_points;
+            float db = snap.peak[i];
             
-            // y 좌표: line=0(최신)이 위쪽(-0.05), line=max(오래됨)가 아래쪽(-0.95)
-            float y_base = -0.05f - 0.9f * line / WATERFALL_HISTORY;
-            float y_next = -0.05f - 0.9f * (line + 1) / WATERFALL_HISTORY;
+            float y = 0.05f + 0.9f * (db - db_min) / (db_max - db_min);
+            y = fmaxf(0.05f, fminf(0.95f, y));
             
-            glBegin(GL_QUADS);
+            glVertex2f(x, y);
+        }
+        
+        glEnd();
+    }
+    
+    glLineWidth(1.0f);
+    
+    // 워터폴 그리기 - 픽셀 기반
+    // 최신 데이터(line=0)가 위쪽, 오래된 데이터가 아래쪽
+    for (size_t line = 0; line < snap.waterfall_lines; line++) {
+        const float* spectrum_line = snap.waterfall.data() + line * num_points;
+        
+        // y 좌표: line=0(최신)이 위쪽(-0.05), line=max(오래됨)가 아래쪽(-0.95)
+        float y_base = -0.05f - 0.9f * line / WATERFALL_HISTORY;
+        float y_next = -0.05f - 0.9f * (line + 1) / WATERFALL_HISTORY;
+        
+        glBegin(GL_QUADS);
+        
+        for (size_t i = 0; i < num_points - 1; i++) {
+            float x1 = -0.95f + 1.9f * i / num_points;
+            float x2 = -0.95f + 1.9f * (i + 1) / num_points;
             
-            // 표시 범위만 그리기
-            for (size_t i = 0; i < num_points - 1; i++) {
-                size_t array_index = display_start_index + i;
-                float x1 = -0.95f + 1.9f * i / num_points;
-                float x2 = -0.95f + 1.9f * (i + 1) / num_points;
-                
-                float db = spectrum_line[array_index];
-                float r, g, b;
-                value_to_color(db, db_min, db_max, r, g, b);
-                
-                glColor3f(r, g, b);
-                glVertex2f(x1, y_base);
-                glVertex2f(x2, y_base);
-                glVertex2f(x2, y_next);
-                glVertex2f(x1, y_next);
-            }
+            float db = spectrum_line[i];
+            float r, g, b;
+            value_to_color(db, db_min, db_max, r, g, b);
             
-            glEnd();
+            glColor3f(r, g, b);
+            glVertex2f(x1, y_base);
+            glVertex2f(x2, y_base);
+            glVertex2f(x2, y_next);
+            glVertex2f(x1, y_next);
         }
+        
+        glEnd();
     }
     
     // 정보 표시 (윈도우 타이틀)
-    char title[256];
-    if (wideband_state.adjust_mode) {
-        snprintf(title, sizeof(title), 
+    if (snap.adjust_mode) {
+        snprintf(title, title_len, 
                  "BladeRF Spectrum | Sweep #%d | [ADJUST MODE] dB: %.0f ~ %.0f | ↑↓: Max | ←→: Min | F: Exit | R: Reset", 
-                 wideband_state.sweep_count, db_min, db_max);
+                 snap.sweep_count, db_min, db_max);
     } else {
-        snprintf(title, sizeof(title), 
-                 "BladeRF Spectrum | Sweep #%d | %llu MHz | dB: %.0f ~ %.0f | F: Adjust Mode | R: Reset | ESC: Quit", 
-                 wideband_state.sweep_count, wideband_state.current_freq / 1000000, db_min, db_max);
+        snprintf(title, title_len, 
+                 "BladeRF Spectrum | Sweep #%d | %llu MHz | RBW %.2f kHz (%d, %s, %s, DC %s) | dB: %.0f ~ %.0f | F: Adjust Mode | [ ]: RBW | W: Window | P: PFB | R: Reset | ESC: Quit", 
+                 snap.sweep_count, (unsigned long long)(snap.current_freq / 1000000),
+                 (double)SAMPLE_RATE / snap.fft_size / 1000.0, snap.fft_size,
+                 window_type_name(snap.window_type), frontend_name(snap.frontend),
+                 dc_mode_name(wideband_state.dc_mode.load()), db_min, db_max);
     }
-    glfwSetWindowTitle(window, title);
 }
 
 // ==================== 키보드 입력 처리 ====================
@@ -663,11 +1058,18 @@ void process_input() {
     static bool left_pressed = false;
     static bool right_pressed = false;
     static bool r_pressed = false;
+    static bool lbracket_pressed = false;
+    static bool rbracket_pressed = false;
+    static bool w_pressed = false;
+    static bool o_pressed = false;
+    static bool p_pressed = false;
+    static bool d_pressed = false;
     
     // F 키 - 조정 모드 토글
     if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS) {
         if (!f_pressed) {
             wideband_state.adjust_mode = !wideband_state.adjust_mode;
+            wideband_state.view_generation++;
             f_pressed = true;
         }
     } else {
@@ -681,6 +1083,7 @@ void process_input() {
             if (!up_pressed) {
                 wideband_state.db_max += 5.0f;
                 if (wideband_state.db_max > 20.0f) wideband_state.db_max = 20.0f;
+                wideband_state.view_generation++;
                 up_pressed = true;
             }
         } else {
@@ -693,6 +1096,7 @@ void process_input() {
                 if (wideband_state.db_max < wideband_state.db_min + 10.0f) {
                     wideband_state.db_max = wideband_state.db_min + 10.0f;
                 }
+                wideband_state.view_generation++;
                 down_pressed = true;
             }
         } else {
@@ -704,6 +1108,7 @@ void process_input() {
             if (!left_pressed) {
                 wideband_state.db_min -= 5.0f;
                 if (wideband_state.db_min < -120.0f) wideband_state.db_min = -120.0f;
+                wideband_state.view_generation++;
                 left_pressed = true;
             }
         } else {
@@ -716,6 +1121,7 @@ void process_input() {
                 if (wideband_state.db_min > wideband_state.db_max - 10.0f) {
                     wideband_state.db_min = wideband_state.db_max - 10.0f;
                 }
+                wideband_state.view_generation++;
                 right_pressed = true;
             }
         } else {
@@ -728,18 +1134,97 @@ void process_input() {
         if (!r_pressed) {
             wideband_state.db_min = -80.0f;
             wideband_state.db_max = -10.0f;
+            wideband_state.view_generation++;
             r_pressed = true;
         }
     } else {
         r_pressed = false;
     }
     
+    // [ / ] 키 - FFT 크기 절반/두 배 (스윕 스레드가 캐시된 플랜으로 전환)
+    if (glfwGetKey(window, GLFW_KEY_LEFT_BRACKET) == GLFW_PRESS) {
+        if (!lbracket_pressed) {
+            int size = wideband_state.requested_fft_size.load();
+            if (size > MIN_FFT_SIZE) {
+                wideband_state.requested_fft_size = size / 2;
+                wideband_state.view_generation++;
+            }
+            lbracket_pressed = true;
+        }
+    } else {
+        lbracket_pressed = false;
+    }
+    
+    if (glfwGetKey(window, GLFW_KEY_RIGHT_BRACKET) == GLFW_PRESS) {
+        if (!rbracket_pressed) {
+            int size = wideband_state.requested_fft_size.load();
+            if (size < MAX_FFT_SIZE) {
+                wideband_state.requested_fft_size = size * 2;
+                wideband_state.view_generation++;
+            }
+            rbracket_pressed = true;
+        }
+    } else {
+        rbracket_pressed = false;
+    }
+    
+    // W 키 - 윈도우 종류 순환
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+        if (!w_pressed) {
+            int type = wideband_state.requested_window_type.load();
+            wideband_state.requested_window_type = (type + 1) % WINDOW_TYPE_COUNT;
+            wideband_state.view_generation++;
+            w_pressed = true;
+        }
+    } else {
+        w_pressed = false;
+    }
+    
+    // O 키 - 점유율 보고 (스윕 스레드가 다음 스윕 끝에서 출력)
+    if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS) {
+        if (!o_pressed) {
+            wideband_state.occupancy_report_requested = true;
+            o_pressed = true;
+        }
+    } else {
+        o_pressed = false;
+    }
+    
+    // P 키 - 프런트엔드 전환 (Hann FFT ↔ PFB 채널라이저, 스텝 간격도 함께 바뀜)
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) {
+        if (!p_pressed) {
+            int frontend = wideband_state.requested_frontend.load();
+            wideband_state.requested_frontend = (frontend + 1) % FRONTEND_COUNT;
+            wideband_state.view_generation++;
+            p_pressed = true;
+        }
+    } else {
+        p_pressed = false;
+    }
+    
+    // D 키 - DC 빈 처리 방식 순환
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
+        if (!d_pressed) {
+            int mode = wideband_state.dc_mode.load();
+            wideband_state.dc_mode = (mode + 1) % DC_MODE_COUNT;
+            wideband_state.view_generation++;
+            d_pressed = true;
+        }
+    } else {
+        d_pressed = false;
+    }
+    
     // ESC 키 - 종료
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
         wideband_state.running = false;
     }
 }
 
+// 윈도우 노출/리사이즈 시 다시 그리기 요청
+void window_refresh_callback(GLFWwindow* /*win*/) {
+    wideband_state.view_generation++;
+}
+
 // ==================== 메인 함수 ====================
 int main(int argc, char** argv) {
     printf("\n");
@@ -748,6 +1233,11 @@ int main(int argc, char** argv) {
     printf("╚═══════════════════════════════════════════╝\n");
     printf("\n");
     
+    // 벤치마크 모드 (BladeRF/윈도우 불필요)
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        return run_frontend_benchmark();
+    }
+    
     // GLUT 초기화 (텍스트 렌더링용)
     glutInit(&argc, argv);
     
@@ -768,6 +1258,7 @@ int main(int argc, char** argv) {
     
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1);  // VSync
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
     
     // OpenGL 설정
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -785,15 +1276,48 @@ int main(int argc, char** argv) {
     
     printf("✓ OpenGL 윈도우 초기화 완료\n");
     
+    // 렌더 스냅샷 버퍼 (최대 FFT 크기 기준, 한 번만 할당)
+    configure_render_snapshot();
+    
     // BladeRF 스윕 스레드 시작
     std::thread sweep_thread(bladerf_sweep_thread);
     
-    // 메인 렌더링 루프
+    // 메인 렌더링 루프 (이벤트 구동)
+    // 새 스텝 데이터(notify_render) 또는 입력이 있을 때만 프레임 생성
+    // 타임아웃은 종료 플래그 확인용
+    uint64_t drawn_data_generation = UINT64_MAX;
+    uint64_t drawn_view_generation = UINT64_MAX;
+    uint64_t frames_rendered = 0;
     while (!glfwWindowShouldClose(window) && wideband_state.running) {
+        glfwWaitEventsTimeout(0.25);
         process_input();
-        render_spectrum();
+        
+        uint64_t data_generation = wideband_state.data_generation.load();
+        uint64_t view_generation = wideband_state.view_generation.load();
+        if (data_generation == drawn_data_generation &&
+            view_generation == drawn_view_generation) {
+            continue;
+        }
+        
+        // 렌더 경로도 첫 프레임(워밍업) 이후에는 힙 할당이 없어야 함
+        // (타이틀 설정은 창 시스템 라이브러리가 문자열 변환에 할당하므로 검사 구간 밖에서)
+        char title[256];
+        uint64_t allocs_before_render = alloc_counter::thread_allocations();
+        render_spectrum(title, sizeof(title));
+        uint64_t render_allocs = alloc_counter::thread_allocations() - allocs_before_render;
+        if (frames_rendered++ > 0 && render_allocs > 0) {
+            fprintf(stderr, "⚠ 렌더: 정상 상태 힙 할당 %llu회 발생\n",
+                    (unsigned long long)render_allocs);
+            if (ALLOC_CHECK_ABORT) abort();
+        }
+        if (title[0] != '\0') update_window_title(title);
         glfwSwapBuffers(window);
-        glfwPollEvents();
+        drawn_data_generation = data_generation;
+        drawn_view_generation = view_generation;
+    }
+    
+    if (static_layer.list != 0) {
+        glDeleteLists(static_layer.list, 1);
     }
     
     // 정리
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdio>
+
+// ==================== 테스트 공통 ====================
+// CHECK: 실패하면 위치와 메시지를 출력하고 계속 진행 (한 번 실행으로 모든 실패를 확인)
+// test_result(): 실패 건수를 출력하고 main의 종료 코드를 반환
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                   \
+    do {                                                   \
+        if (!(cond)) {                                     \
+            printf("❌ %s:%d: ", __FILE__, __LINE__);      \
+            printf(__VA_ARGS__);                           \
+            printf("\n");                                  \
+            failures++;                                    \
+        }                                                  \
+    } while (0)
+
+inline int test_result() {
+    if (failures > 0) {
+        printf("❌ 실패 %d건\n", failures);
+        return 1;
+    }
+    return 0;
+}
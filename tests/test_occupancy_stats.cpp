@@ -0,0 +1,360 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "occupancy_stats.h"
+#include "occupancy_checkpoint.h"
+#include "test_check.h"
+
+// ==================== 점유율 통계 검증 ====================
+//  - measured 마스크가 0인 빈은 최소/최대/평균/듀티/히스토그램/에포크 어디에도 반영되지 않음
+//  - 빈별 결과가 단순 참조 구현과 일치 (AVX2 경로의 마스크 처리 검증)
+//  - 마스크 nullptr은 전체 측정과 동일
+//  - 시간 창 질의는 창과 겹치는 닫힌 에포크(링에서 밀려난 것 제외)와 진행 중인 에포크만 반영
+//  - 체크포인트 저장/복원 왕복, 구성 불일치/손상된 에포크 링 위치 거부, 백그라운드 writer 스냅샷
+
+#define NUM_BINS      1003      // 8의 배수가 아니게 해서 스칼라 꼬리도 거침
+#define NUM_SWEEPS    25
+#define START_HZ      50e6
+#define HZ_PER_BIN    4500.0
+#define T0            1.7e9
+#define CKPT_PATH     "test_occupancy_stats.ckpt"
+
+double bin_center_hz(size_t bin) {
+    return START_HZ + (bin + 0.5) * HZ_PER_BIN;
+}
+
+uint32_t lcg_next(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+void test_unmeasured_bins_ignored() {
+    OccupancyStats stats;
+    stats.configure(NUM_BINS, START_HZ, HZ_PER_BIN, OccupancyConfig());
+
+    // 측정된 빈(짝수)은 -50 dB, 측정 안 된 빈(홀수)은 초기화 채움값 -80 dB
+    std::vector<float> spectrum(NUM_BINS);
+    std::vector<uint8_t> measured(NUM_BINS);
+    for (size_t i = 0; i < NUM_BINS; i++) {
+        measured[i] = (i % 2 == 0) ? 1 : 0;
+        spectrum[i] = measured[i] ? -50.0f : -80.0f;
+    }
+    for (int sweep = 0; sweep < NUM_SWEEPS; sweep++) {
+        stats.update(spectrum.data(), measured.data(), 0, NUM_BINS - 1, 1.7e9 + sweep);
+    }
+
+    double f_lo = bin_center_hz(0);
+    double f_hi = bin_center_hz(NUM_BINS - 1);
+    OccupancySummary summary = stats.query(f_lo, f_hi);
+    size_t measured_bins = (NUM_BINS + 1) / 2;
+    CHECK(summary.samples == measured_bins * NUM_SWEEPS, "samples %llu, expected %zu",
+          (unsigned long long)summary.samples, measured_bins * NUM_SWEEPS);
+    CHECK(summary.min_db == -50.0f, "min %.2f includes unmeasured fill", summary.min_db);
+    CHECK(fabsf(summary.mean_db + 50.0f) < 0.01f, "mean %.3f includes unmeasured fill", summary.mean_db);
+    CHECK(summary.duty == 1.0f, "duty %.3f includes unmeasured fill", summary.duty);
+
+    float p10 = stats.percentile(f_lo, f_hi, 10.0f);
+    CHECK(p10 > -53.0f, "p10 %.2f includes unmeasured fill", p10);
+
+    OccupancySummary window = stats.query_window(f_lo, f_hi, 0.0, 2e9);
+    CHECK(window.min_db == -50.0f && window.duty == 1.0f,
+          "epoch columns include unmeasured fill (min %.2f, duty %.3f)", window.min_db, window.duty);
+
+    // 측정되지 않은 빈 하나만 질의하면 샘플 없음
+    OccupancySummary odd = stats.query(bin_center_hz(1), bin_center_hz(1));
+    CHECK(odd.samples == 0, "unmeasured bin has %llu samples", (unsigned long long)odd.samples);
+    printf("✓ 측정되지 않은 빈 제외: 샘플 %llu, 최소 %.1f dB, 듀티 %.2f, P10 %.1f dB\n",
+           (unsigned long long)summary.samples, summary.min_db, summary.duty, p10);
+}
+
+void test_matches_reference() {
+    OccupancyConfig config;
+    OccupancyStats stats;
+    stats.configure(NUM_BINS, START_HZ, HZ_PER_BIN, config);
+
+    std::vector<float> ref_min(NUM_BINS, INFINITY);
+    std::vector<float> ref_max(NUM_BINS, -INFINITY);
+    std::vector<double> ref_lin(NUM_BINS, 0.0);
+    std::vector<uint32_t> ref_count(NUM_BINS, 0);
+    std::vector<uint32_t> ref_above(NUM_BINS, 0);
+
+    std::vector<float> spectrum(NUM_BINS);
+    std::vector<uint8_t> measured(NUM_BINS);
+    uint32_t state = 2024;
+    for (int sweep = 0; sweep < NUM_SWEEPS; sweep++) {
+        // 매 스윕 임의 부분 범위 + 임의 마스크
+        size_t first = lcg_next(state) % 40;
+        size_t last = NUM_BINS - 1 - lcg_next(state) % 40;
+        for (size_t i = 0; i < NUM_BINS; i++) {
+            spectrum[i] = -100.0f + (float)(lcg_next(state) % 7000) * 0.01f;
+            measured[i] = (lcg_next(state) % 3) != 0 ? 1 : 0;
+        }
+        stats.update(spectrum.data(), measured.data(), first, last, 1.7e9 + sweep);
+
+        for (size_t i = first; i <= last; i++) {
+            if (!measured[i]) continue;
+            ref_min[i] = fminf(ref_min[i], spectrum[i]);
+            ref_max[i] = fmaxf(ref_max[i], spectrum[i]);
+            ref_lin[i] += expf(spectrum[i] * 0.230258509f);
+            ref_count[i]++;
+            ref_above[i] += spectrum[i] > config.duty_threshold_db ? 1 : 0;
+        }
+    }
+
+    int mismatches = 0;
+    for (size_t i = 0; i < NUM_BINS; i++) {
+        OccupancySummary s = stats.query(bin_center_hz(i), bin_center_hz(i));
+        bool ok = s.samples == ref_count[i];
+        if (ok && ref_count[i] > 0) {
+            float ref_mean = (float)(10.0 * log10(ref_lin[i] / ref_count[i]));
+            ok = s.min_db == ref_min[i] && s.max_db == ref_max[i] &&
+                 fabsf(s.mean_db - ref_mean) < 1e-3f &&
+                 fabsf(s.duty - (float)ref_above[i] / ref_count[i]) < 1e-6f;
+        }
+        if (!ok && mismatches++ < 5) {
+            printf("  bin %zu: samples %llu/%u min %.2f/%.2f max %.2f/%.2f\n", i,
+                   (unsigned long long)s.samples, ref_count[i], s.min_db, ref_min[i], s.max_db, ref_max[i]);
+        }
+    }
+    CHECK(mismatches == 0, "%d bins differ from reference", mismatches);
+    printf("✓ 참조 구현과 일치: 빈 %d개 × 스윕 %d회 (임의 마스크/범위)\n", NUM_BINS, NUM_SWEEPS);
+}
+
+void test_null_mask_is_all_measured() {
+    OccupancyStats a, b;
+    a.configure(NUM_BINS, START_HZ, HZ_PER_BIN, OccupancyConfig());
+    b.configure(NUM_BINS, START_HZ, HZ_PER_BIN, OccupancyConfig());
+
+    std::vector<float> spectrum(NUM_BINS);
+    std::vector<uint8_t> all(NUM_BINS, 1);
+    uint32_t state = 7;
+    for (int sweep = 0; sweep < NUM_SWEEPS; sweep++) {
+        for (size_t i = 0; i < NUM_BINS; i++) {
+            spectrum[i] = -100.0f + (float)(lcg_next(state) % 7000) * 0.01f;
+        }
+        a.update(spectrum.data(), nullptr, 0, NUM_BINS - 1, 1.7e9 + sweep);
+        b.update(spectrum.data(), all.data(), 0, NUM_BINS - 1, 1.7e9 + sweep);
+    }
+
+    OccupancySummary sa = a.query(START_HZ, START_HZ + NUM_BINS * HZ_PER_BIN);
+    OccupancySummary sb = b.query(START_HZ, START_HZ + NUM_BINS * HZ_PER_BIN);
+    CHECK(sa.samples == sb.samples && sa.min_db == sb.min_db && sa.max_db == sb.max_db &&
+          sa.mean_db == sb.mean_db && sa.duty == sb.duty, "null mask differs from all-measured mask");
+    printf("✓ 마스크 없음 = 전체 측정\n");
+}
+
+// 초당 1스윕, 10초 에포크, 링 4개: 에포크 k(t = 10k ~ 10k+9)는 모든 빈이 -100 + 10k dB
+void feed_epochs(OccupancyStats& stats, int seconds) {
+    std::vector<float> spectrum(NUM_BINS);
+    for (int t = 0; t < seconds; t++) {
+        std::fill(spectrum.begin(), spectrum.end(), -100.0f + 10.0f * (t / 10));
+        stats.update(spectrum.data(), nullptr, 0, NUM_BINS - 1, T0 + t);
+    }
+}
+
+OccupancyConfig epoch_config() {
+    OccupancyConfig config;
+    config.epoch_seconds = 10.0;
+    config.max_epochs = 4;
+    return config;
+}
+
+void test_query_window_epochs() {
+    OccupancyStats stats;
+    stats.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    feed_epochs(stats, 60);   // 닫힌 에포크 0~4 (0은 링에서 밀려남), 진행 중 5
+
+    double f_lo = bin_center_hz(0);
+    double f_hi = bin_center_hz(NUM_BINS - 1);
+    CHECK(stats.epoch_count() == 4, "epoch count %d", stats.epoch_count());
+
+    OccupancySummary one = stats.query_window(f_lo, f_hi, T0 + 21, T0 + 28);
+    CHECK(one.samples == NUM_BINS && one.min_db == -80.0f && one.max_db == -80.0f,
+          "window inside epoch 2: samples %llu min %.1f max %.1f",
+          (unsigned long long)one.samples, one.min_db, one.max_db);
+
+    OccupancySummary span = stats.query_window(f_lo, f_hi, T0 + 15, T0 + 35);
+    CHECK(span.samples == 3 * NUM_BINS && span.min_db == -90.0f && span.max_db == -70.0f,
+          "window over epochs 1-3: samples %llu min %.1f max %.1f",
+          (unsigned long long)span.samples, span.min_db, span.max_db);
+
+    OccupancySummary dropped = stats.query_window(f_lo, f_hi, T0 + 2, T0 + 8);
+    CHECK(dropped.samples == 0 && std::isnan(dropped.min_db),
+          "epoch 0 left the ring but window has %llu samples", (unsigned long long)dropped.samples);
+
+    OccupancySummary open = stats.query_window(f_lo, f_hi, T0 + 55, T0 + 100);
+    CHECK(open.samples == NUM_BINS && open.min_db == -50.0f && open.max_db == -50.0f,
+          "window over open epoch: samples %llu min %.1f max %.1f",
+          (unsigned long long)open.samples, open.min_db, open.max_db);
+
+    OccupancySummary gap = stats.query_window(f_lo, f_hi, T0 + 29.5, T0 + 29.9);
+    CHECK(gap.samples == 0, "window between epochs has %llu samples", (unsigned long long)gap.samples);
+
+    OccupancySummary all = stats.query_window(f_lo, f_hi, 0.0, T0 + 100);
+    CHECK(all.samples == 5 * NUM_BINS && all.min_db == -90.0f && all.max_db == -50.0f,
+          "whole window: samples %llu min %.1f max %.1f",
+          (unsigned long long)all.samples, all.min_db, all.max_db);
+    printf("✓ 시간 창 질의: 에포크 하나 / 여러 개 / 링에서 밀려난 에포크 / 진행 중인 에포크\n");
+}
+
+bool same_summary(const OccupancySummary& a, const OccupancySummary& b) {
+    auto same = [](float x, float y) { return x == y || (std::isnan(x) && std::isnan(y)); };
+    return a.samples == b.samples && same(a.min_db, b.min_db) && same(a.max_db, b.max_db) &&
+           same(a.mean_db, b.mean_db) && same(a.duty, b.duty);
+}
+
+// 전체 기간/백분위/시간 창 질의가 모두 같은지
+bool same_queries(const OccupancyStats& a, const OccupancyStats& b) {
+    bool ok = a.sweeps() == b.sweeps() && a.epoch_count() == b.epoch_count() &&
+              a.first_time() == b.first_time() && a.last_time() == b.last_time();
+    for (size_t bin = 0; ok && bin < NUM_BINS; bin += 97) {
+        double f = bin_center_hz(bin);
+        ok = same_summary(a.query(f, f), b.query(f, f)) &&
+             same_summary(a.query_window(f, f, T0 + 15, T0 + 35), b.query_window(f, f, T0 + 15, T0 + 35));
+    }
+    double f_lo = bin_center_hz(0);
+    double f_hi = bin_center_hz(NUM_BINS - 1);
+    float pa = a.percentile(f_lo, f_hi, 90.0f);
+    float pb = b.percentile(f_lo, f_hi, 90.0f);
+    return ok && (pa == pb || (std::isnan(pa) && std::isnan(pb))) &&
+           same_summary(a.query_window(f_lo, f_hi, 0.0, T0 + 1000), b.query_window(f_lo, f_hi, 0.0, T0 + 1000));
+}
+
+void test_checkpoint_round_trip() {
+    OccupancyStats saved;
+    saved.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    feed_epochs(saved, 45);
+    CHECK(saved.save_checkpoint(CKPT_PATH), "save failed");
+
+    OccupancyStats loaded;
+    loaded.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    CHECK(loaded.load_checkpoint(CKPT_PATH), "load failed");
+    CHECK(same_queries(saved, loaded), "loaded stats differ from saved");
+
+    // 복원 후 이어서 누적해도 (에포크 링이 한 바퀴 돌아도) 같은 결과
+    std::vector<float> spectrum(NUM_BINS, -30.0f);
+    for (int t = 45; t < 90; t++) {
+        saved.update(spectrum.data(), nullptr, 0, NUM_BINS - 1, T0 + t);
+        loaded.update(spectrum.data(), nullptr, 0, NUM_BINS - 1, T0 + t);
+    }
+    CHECK(same_queries(saved, loaded), "stats diverge after continuing from checkpoint");
+    printf("✓ 체크포인트 왕복: 스윕 %llu회, 에포크 %d개, 복원 후 누적도 동일\n",
+           (unsigned long long)loaded.sweeps(), loaded.epoch_count());
+}
+
+void test_checkpoint_config_mismatch() {
+    OccupancyStats saved;
+    saved.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    feed_epochs(saved, 25);
+    CHECK(saved.save_checkpoint(CKPT_PATH), "save failed");
+
+    OccupancyConfig threshold = epoch_config();
+    threshold.duty_threshold_db = -70.0f;
+    OccupancyConfig epochs = epoch_config();
+    epochs.max_epochs = 8;
+
+    struct Mismatch {
+        const char* name;
+        size_t num_bins;
+        double start_hz;
+        OccupancyConfig config;
+    } cases[] = {
+        {"num_bins", NUM_BINS + 1, START_HZ, epoch_config()},
+        {"start_hz", NUM_BINS, START_HZ + 1000.0, epoch_config()},
+        {"duty threshold", NUM_BINS, START_HZ, threshold},
+        {"max_epochs", NUM_BINS, START_HZ, epochs},
+    };
+    for (const Mismatch& m : cases) {
+        OccupancyStats loaded;
+        loaded.configure(m.num_bins, m.start_hz, HZ_PER_BIN, m.config);
+        CHECK(!loaded.load_checkpoint(CKPT_PATH), "checkpoint accepted with different %s", m.name);
+        CHECK(loaded.sweeps() == 0 && loaded.epoch_count() == 0, "rejected load left state (%s)", m.name);
+    }
+    printf("✓ 구성이 다른 체크포인트 거부 (빈 수, 주파수 축, 임계값, 에포크 수)\n");
+}
+
+// CheckpointHeader의 epoch_head/epoch_count 오프셋 (magic 8 + 고정 필드 88바이트)
+#define CKPT_EPOCH_HEAD_OFFSET  96
+
+bool patch_epoch_ring(int32_t head, int32_t count) {
+    FILE* f = fopen(CKPT_PATH, "r+b");
+    if (!f) return false;
+    int32_t ring[2] = {head, count};
+    bool ok = fseek(f, CKPT_EPOCH_HEAD_OFFSET, SEEK_SET) == 0 && fwrite(ring, sizeof(ring), 1, f) == 1;
+    return (fclose(f) == 0) && ok;
+}
+
+void test_checkpoint_epoch_bounds() {
+    OccupancyStats saved;
+    saved.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    feed_epochs(saved, 25);   // head 2, count 2
+    CHECK(saved.save_checkpoint(CKPT_PATH), "save failed");
+
+    // 오프셋 확인: 원래 값 그대로 다시 쓰면 복원 성공
+    CHECK(patch_epoch_ring(2, 2), "patch failed");
+    OccupancyStats loaded;
+    loaded.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    CHECK(loaded.load_checkpoint(CKPT_PATH) && loaded.epoch_count() == 2, "unpatched checkpoint rejected");
+
+    int32_t bad[][2] = {{-1, 2}, {4, 2}, {1000000, 2}, {2, -1}, {2, 5}, {1, 2}};
+    for (const auto& ring : bad) {
+        CHECK(patch_epoch_ring(ring[0], ring[1]), "patch failed");
+        OccupancyStats corrupt;
+        corrupt.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+        CHECK(!corrupt.load_checkpoint(CKPT_PATH), "accepted epoch_head %d epoch_count %d", ring[0], ring[1]);
+        CHECK(corrupt.epoch_count() == 0, "rejected load left epoch_count %d", corrupt.epoch_count());
+    }
+
+    // 링이 가득 찬 뒤에는 head가 어디든 유효
+    OccupancyStats full;
+    full.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    feed_epochs(full, 65);   // 에포크 6개 닫힘 → count 4, head 2
+    CHECK(full.save_checkpoint(CKPT_PATH), "save failed");
+    OccupancyStats reloaded;
+    reloaded.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    CHECK(reloaded.load_checkpoint(CKPT_PATH) && same_queries(full, reloaded), "full ring checkpoint rejected");
+    printf("✓ 범위를 벗어난 에포크 링 위치 거부 (가득 찬 링은 허용)\n");
+}
+
+void test_background_writer() {
+    OccupancyStats stats;
+    stats.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    feed_epochs(stats, 25);
+
+    OccupancyCheckpointWriter writer;
+    writer.prepare(stats);
+    CHECK(writer.submit(stats, CKPT_PATH), "submit rejected on idle writer");
+
+    // 요청 이후의 변경은 파일에 들어가지 않음 (제출 시점 스냅샷)
+    OccupancyStats expected = stats;
+    feed_epochs(stats, 5);
+    writer.wait();
+    CHECK(writer.written() == 1 && writer.failed() == 0, "written %llu failed %llu",
+          (unsigned long long)writer.written(), (unsigned long long)writer.failed());
+
+    OccupancyStats loaded;
+    loaded.configure(NUM_BINS, START_HZ, HZ_PER_BIN, epoch_config());
+    CHECK(loaded.load_checkpoint(CKPT_PATH), "load of background checkpoint failed");
+    CHECK(same_queries(expected, loaded), "background checkpoint is not the submitted snapshot");
+
+    // 종료 시 남은 쓰기를 마침
+    CHECK(writer.submit(stats, CKPT_PATH), "second submit rejected");
+    writer.stop();
+    CHECK(writer.written() == 2, "pending write lost on stop");
+    printf("✓ 백그라운드 체크포인트 writer: 제출 시점 스냅샷 저장, 종료 시 남은 쓰기 완료\n");
+}
+
+int main() {
+    test_unmeasured_bins_ignored();
+    test_matches_reference();
+    test_null_mask_is_all_measured();
+    test_query_window_epochs();
+    test_checkpoint_round_trip();
+    test_checkpoint_config_mismatch();
+    test_checkpoint_epoch_bounds();
+    test_background_writer();
+    remove(CKPT_PATH);
+
+    return test_result();
+}
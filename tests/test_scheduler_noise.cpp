@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "fft_plan_cache.h"
+#include "spectrum_frontend.h"
+#include "sweep_pipeline.h"
+#include "sweep_scheduler.h"
+#include "test_check.h"
+
+// ==================== 잡음만 있는 스텝의 체류 검증 ====================
+// 합성 가우시안 잡음을 실제 스윕 경로(compute_spectrum → average_frames → measure_step)로 처리해
+// 스케줄러에 보고:
+//  - 잡음만 있는 스텝은 잡음 레벨과 무관하게 항상 min_dwell_chunks (기본 기준선과 실측 기준선 모두)
+//  - 톤이 있는 스텝은 더 길게, 더 자주 방문
+
+#define SAMPLE_RATE       61440000
+#define STEP_HZ           50000000ULL
+#define FFT_SIZE          8192
+#define PFB_TAPS          8
+#define PFB_BIN_WIDTH     1.5
+#define DC_NOTCH_HZ       10000
+#define NUM_STEPS         8
+#define NUM_SWEEPS        12
+#define MIN_DWELL         1
+#define MAX_DWELL         4
+#define ACTIVE_STEP       5
+
+// 스텝마다 잡음 레벨이 다름 (플로어가 고르지 않은 대역), 활동 스텝에는 스티칭 범위 안에 톤 3개 추가
+void fill_step_iq(int16_t* iq, size_t samples, int step, bool active, uint32_t& state) {
+    fill_gaussian_noise(iq, samples, 8.0f * (1 + step), state);
+    if (!active || step != ACTIVE_STEP) return;
+    for (size_t n = 0; n < samples; n++) {
+        double i_sum = 0.0, q_sum = 0.0;
+        for (int tone = 1; tone <= 3; tone++) {
+            double phase = 2.0 * M_PI * (tone * 613 - 1200) * (double)n / FFT_SIZE;
+            i_sum += 400.0 * cos(phase);
+            q_sum += 400.0 * sin(phase);
+        }
+        iq[2 * n] = (int16_t)(iq[2 * n] + i_sum);
+        iq[2 * n + 1] = (int16_t)(iq[2 * n + 1] + q_sum);
+    }
+}
+
+struct NoiseRun {
+    std::vector<int> visit_count;
+    std::vector<int> dwell_sum;
+    std::vector<int> max_dwell;
+    std::vector<float> score;
+};
+
+NoiseRun run(FftPlanCache& cache, FrontEnd frontend, bool calibrate, bool active) {
+    FftSetup fft = cache.get(FFT_SIZE, WINDOW_HANN);
+    bool use_pfb = frontend == FRONTEND_PFB;
+    int taps = use_pfb ? PFB_TAPS : 1;
+    size_t spectrum_samples = (size_t)FFT_SIZE * taps;
+    StitchRange range = stitch_range(FFT_SIZE, SAMPLE_RATE, STEP_HZ);
+    int dc_half_width = dc_half_width_bins(DC_NOTCH_HZ, FFT_SIZE, SAMPLE_RATE);
+
+    SweepArena arena;
+    arena.configure(FFT_SIZE, (size_t)(taps + MAX_DWELL - 1) * FFT_SIZE, 0);
+
+    SweepSchedulerConfig config;
+    config.min_dwell_chunks = MIN_DWELL;
+    config.max_dwell_chunks = MAX_DWELL;
+    SweepScheduler scheduler;
+    scheduler.configure(NUM_STEPS, config);
+    if (calibrate) {
+        calibrate_noise_baseline(scheduler, fft, use_pfb, DC_INTERPOLATE, dc_half_width, range,
+                                 FFT_SIZE, spectrum_samples, arena);
+    }
+
+    NoiseRun result;
+    result.visit_count.assign(NUM_STEPS, 0);
+    result.dwell_sum.assign(NUM_STEPS, 0);
+    result.max_dwell.assign(NUM_STEPS, 0);
+    uint32_t state = 12345u;   // 보정과 다른 잡음 시퀀스
+
+    for (int sweep = 0; sweep < NUM_SWEEPS; sweep++) {
+        scheduler.begin_sweep();
+        while (!scheduler.coverage_complete()) {
+            SweepVisit visit = scheduler.next();
+            // 스윕 스레드와 같은 캡처: 프레임 간격 FFT_SIZE (PFB 프레임은 겹침)
+            fill_step_iq(arena.iq_buffer.data(), (size_t)(taps + visit.dwell_chunks - 1) * FFT_SIZE,
+                         visit.step, active, state);
+            average_frames(fft, use_pfb, DC_INTERPOLATE, dc_half_width, arena.iq_buffer.data(),
+                           FFT_SIZE, visit.dwell_chunks, arena.fft_result.data(),
+                           arena.avg_spectrum.data());
+
+            StepStats stats = measure_step(arena.avg_spectrum.data(), range);
+            StepActivity activity;
+            activity.mean_db = stats.mean_db;
+            activity.peak_db = stats.max_db;
+            activity.variance_db = stats.variance_db;
+            activity.dwell_chunks = visit.dwell_chunks;
+            scheduler.report(visit.step, activity);
+
+            result.visit_count[visit.step]++;
+            result.dwell_sum[visit.step] += visit.dwell_chunks;
+            if (visit.dwell_chunks > result.max_dwell[visit.step]) {
+                result.max_dwell[visit.step] = visit.dwell_chunks;
+            }
+        }
+    }
+    for (int step = 0; step < NUM_STEPS; step++) result.score.push_back(scheduler.score(step));
+
+    if (calibrate && !active) {
+        printf("  %s 잡음 기준선:", frontend_name(frontend));
+        for (int dwell = MIN_DWELL; dwell <= MAX_DWELL; dwell++) {
+            printf(" [%d] 분산 %.1f dB² 피크 +%.1f dB", dwell, scheduler.noise_variance(dwell),
+                   scheduler.noise_peak_excess(dwell));
+        }
+        printf("\n");
+    }
+    return result;
+}
+
+void test_noise_stays_at_min_dwell(FftPlanCache& cache, FrontEnd frontend, bool calibrate) {
+    NoiseRun result = run(cache, frontend, calibrate, false);
+    const char* baseline = calibrate ? "실측 기준선" : "기본 기준선";
+
+    float max_score = 0.0f;
+    for (int step = 0; step < NUM_STEPS; step++) {
+        CHECK(result.visit_count[step] == NUM_SWEEPS, "%s/%s: step %d visited %d times",
+              frontend_name(frontend), baseline, step, result.visit_count[step]);
+        CHECK(result.max_dwell[step] == MIN_DWELL, "%s/%s: noise-only step %d reached dwell %d",
+              frontend_name(frontend), baseline, step, result.max_dwell[step]);
+        if (result.score[step] > max_score) max_score = result.score[step];
+    }
+    printf("✓ %s, %s: 잡음만 있는 스텝 체류 %d 유지 (최대 점수 %.3f)\n", frontend_name(frontend),
+           baseline, MIN_DWELL, max_score);
+}
+
+void test_active_step(FftPlanCache& cache, FrontEnd frontend) {
+    NoiseRun result = run(cache, frontend, true, true);
+
+    double active_dwell = (double)result.dwell_sum[ACTIVE_STEP] / result.visit_count[ACTIVE_STEP];
+    int quiet_visits = 0;
+    for (int step = 0; step < NUM_STEPS; step++) {
+        if (step == ACTIVE_STEP) continue;
+        CHECK(result.max_dwell[step] == MIN_DWELL, "%s active: quiet step %d reached dwell %d",
+              frontend_name(frontend), step, result.max_dwell[step]);
+        quiet_visits += result.visit_count[step];
+    }
+    double quiet_mean_visits = (double)quiet_visits / (NUM_STEPS - 1);
+    CHECK(active_dwell > MIN_DWELL + 0.5, "%s active: dwell %.2f", frontend_name(frontend), active_dwell);
+    CHECK(result.visit_count[ACTIVE_STEP] > quiet_mean_visits, "%s active: %d visits vs quiet %.1f",
+          frontend_name(frontend), result.visit_count[ACTIVE_STEP], quiet_mean_visits);
+    printf("✓ %s: 톤이 있는 스텝 평균 체류 %.2f, 방문 %d회 (잡음 스텝 %.1f회)\n", frontend_name(frontend),
+           active_dwell, result.visit_count[ACTIVE_STEP], quiet_mean_visits);
+}
+
+int main() {
+    FftPlanCache cache(PFB_TAPS, PFB_BIN_WIDTH);
+    for (int f = 0; f < FRONTEND_COUNT; f++) {
+        FrontEnd frontend = (FrontEnd)f;
+        test_noise_stays_at_min_dwell(cache, frontend, true);
+        test_noise_stays_at_min_dwell(cache, frontend, false);
+        test_active_step(cache, frontend);
+    }
+
+    return test_result();
+}
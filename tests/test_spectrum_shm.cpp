@@ -0,0 +1,304 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <sys/wait.h>
+#include "spectrum_shm.h"
+#include "test_check.h"
+
+// ==================== 스펙트럼 공유 메모리 검증 ====================
+//  - writer가 게시 도중 종료돼 seq가 홀수로 남은 슬롯을 다시 열 때 짝수로 되돌리고,
+//    찢어진 게시 번호는 어떤 reader도 받아들이지 않음
+//  - 홀수 seq에서 시작한 게시도 끝나면 짝수 (reader가 영원히 거부하지 않음)
+//  - measured 마스크가 그대로 게시되고, nullptr은 전체 측정으로 게시
+//  - 살아 있는 writer가 있으면 두 번째 writer는 EBUSY, 죽은 writer가 남긴 세그먼트는 인수
+//  - 레이아웃이 바뀌면 새 세그먼트: 옛 세그먼트를 매핑한 reader는 옛 게시를 계속 읽음
+
+#define SHM_NAME      "/bladerf_spectrum_shmtest"
+#define SHM_SLOTS     4
+#define MAX_BINS      4099      // 슬롯 간격 정렬이 빈 수와 무관하게 맞는지도 확인
+#define NUM_BINS      4000
+
+// 다른 프로세스(죽은 writer)처럼 세그먼트를 직접 매핑해 슬롯 메타데이터에 접근
+struct RawSegment {
+    uint8_t* base = nullptr;
+    size_t size = 0;
+
+    bool map(const char* name) {
+        int fd = shm_open(name, O_RDWR, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base = (uint8_t*)p;
+        size = (size_t)st.st_size;
+        return true;
+    }
+
+    ~RawSegment() {
+        if (base) munmap(base, size);
+    }
+
+    const SpectrumShmHeader* header() const { return (const SpectrumShmHeader*)base; }
+
+    SpectrumSlotMeta* slot(uint64_t index) const {
+        const SpectrumShmHeader* h = header();
+        return (SpectrumSlotMeta*)(base + h->header_size + index * h->slot_stride);
+    }
+};
+
+void fill_sweep(std::vector<float>& bins, std::vector<uint8_t>& measured, uint64_t sweep) {
+    for (uint32_t i = 0; i < NUM_BINS; i++) {
+        bins[i] = -90.0f + (float)((i * 2654435761u + sweep * 40503u) % 5000) * 0.01f;
+        measured[i] = (uint8_t)((i + sweep) % 5 < 3);
+    }
+}
+
+bool publish_sweep(SpectrumShmWriter& writer, std::vector<float>& bins, std::vector<uint8_t>& measured,
+                   uint64_t sweep) {
+    fill_sweep(bins, measured, sweep);
+    SpectrumSweepInfo info = {};
+    info.sweep_count = sweep;
+    info.start_hz = 70e6;
+    info.hz_per_bin = 7500.0;
+    info.fft_size = 8192;
+    info.first_bin = 0;
+    info.last_bin = NUM_BINS - 1;
+    return writer.publish(info, bins.data(), measured.data(), NUM_BINS);
+}
+
+bool all_slots_even(const RawSegment& raw) {
+    for (uint32_t i = 0; i < raw.header()->slot_count; i++) {
+        if (raw.slot(i)->seq.load(std::memory_order_acquire) & 1) return false;
+    }
+    return true;
+}
+
+void test_reopen_after_torn_publish() {
+    std::vector<float> bins(NUM_BINS);
+    std::vector<uint8_t> measured(NUM_BINS);
+
+    SpectrumShmWriter writer;
+    CHECK(writer.open(SHM_NAME, SHM_SLOTS, MAX_BINS, 70000000, 100000000, 61440000),
+          "writer open failed: %s", strerror(errno));
+    for (uint64_t sweep = 1; sweep <= 3; sweep++) publish_sweep(writer, bins, measured, sweep);
+    writer.close();
+
+    // 게시 #4 도중 종료: seq 홀수, 메타데이터는 이미 #4로 기록, 빈은 반쯤 기록
+    RawSegment raw;
+    CHECK(raw.map(SHM_NAME), "raw map failed: %s", strerror(errno));
+    if (!raw.base) return;
+    SpectrumSlotMeta* torn = raw.slot(4 % SHM_SLOTS);
+    uint64_t torn_seq = torn->seq.load(std::memory_order_relaxed);
+    torn->seq.store(torn_seq + 1, std::memory_order_relaxed);
+    torn->info.sequence = 4;
+    torn->info.num_bins = NUM_BINS;
+    CHECK(!all_slots_even(raw), "torn slot setup");
+
+    CHECK(writer.open(SHM_NAME, SHM_SLOTS, MAX_BINS, 70000000, 100000000, 61440000),
+          "writer reopen failed: %s", strerror(errno));
+    CHECK(writer.sequence() == 3, "sequence not continued: %llu", (unsigned long long)writer.sequence());
+    CHECK(all_slots_even(raw), "odd slot seq survived reopen");
+
+    SpectrumShmReader reader;
+    CHECK(reader.open(SHM_NAME), "reader open failed");
+    SpectrumView view = {};
+    CHECK(!reader.acquire(4, view), "torn sequence 4 acquirable after reopen");
+    CHECK(reader.acquire_latest(view) && view.info.sequence == 3, "latest before republish");
+
+    // 같은 슬롯에 새 게시 → 정상 읽기
+    publish_sweep(writer, bins, measured, 4);
+    CHECK(all_slots_even(raw), "odd slot seq after republish");
+    CHECK(reader.acquire_latest(view) && view.info.sequence == 4, "republished sweep not acquirable");
+    CHECK(spectrum_shm_checksum(view.bins, view.measured, view.info.num_bins) == view.info.checksum,
+          "checksum mismatch");
+    CHECK(reader.still_valid(view), "view invalidated without writer");
+
+    writer.close();
+    printf("✓ 게시 도중 종료된 writer 재시작 후 seq 짝수, 찢어진 게시 거부\n");
+}
+
+void test_publish_from_odd_seq() {
+    std::vector<float> bins(NUM_BINS);
+    std::vector<uint8_t> measured(NUM_BINS);
+
+    SpectrumShmWriter writer;
+    CHECK(writer.open(SHM_NAME, SHM_SLOTS, MAX_BINS, 70000000, 100000000, 61440000),
+          "writer open failed: %s", strerror(errno));
+    RawSegment raw;
+    CHECK(raw.map(SHM_NAME), "raw map failed: %s", strerror(errno));
+    if (!raw.base) return;
+
+    // 다음 게시 슬롯의 seq를 홀수로 만든 뒤 게시
+    uint64_t next = writer.sequence() + 1;
+    SpectrumSlotMeta* meta = raw.slot(next % SHM_SLOTS);
+    meta->seq.store(meta->seq.load(std::memory_order_relaxed) | 1, std::memory_order_relaxed);
+    publish_sweep(writer, bins, measured, next);
+
+    CHECK((meta->seq.load(std::memory_order_acquire) & 1) == 0, "publish left odd seq");
+    SpectrumShmReader reader;
+    CHECK(reader.open(SHM_NAME), "reader open failed");
+    SpectrumView view = {};
+    CHECK(reader.acquire(next, view), "sweep published from odd seq not acquirable");
+
+    writer.close();
+    printf("✓ 홀수 seq에서 시작한 게시도 짝수로 완료\n");
+}
+
+void test_measured_mask_published() {
+    std::vector<float> bins(NUM_BINS);
+    std::vector<uint8_t> measured(NUM_BINS);
+
+    SpectrumShmWriter writer;
+    CHECK(writer.open(SHM_NAME, SHM_SLOTS, MAX_BINS, 70000000, 100000000, 61440000),
+          "writer open failed: %s", strerror(errno));
+    SpectrumShmReader reader;
+    CHECK(reader.open(SHM_NAME), "reader open failed");
+
+    publish_sweep(writer, bins, measured, 10);
+    std::vector<float> copy(MAX_BINS);
+    std::vector<uint8_t> copy_measured(MAX_BINS);
+    SpectrumSweepInfo info = {};
+    CHECK(reader.copy_latest(info, copy.data(), MAX_BINS, copy_measured.data()), "copy_latest failed");
+    CHECK(info.num_bins == NUM_BINS, "num_bins %u", info.num_bins);
+    CHECK(memcmp(copy.data(), bins.data(), NUM_BINS * sizeof(float)) == 0, "bins differ");
+    CHECK(memcmp(copy_measured.data(), measured.data(), NUM_BINS) == 0, "measured mask differs");
+
+    // 마스크 없이 게시 → 전체 측정
+    SpectrumSweepInfo plain = {};
+    plain.first_bin = 0;
+    plain.last_bin = NUM_BINS - 1;
+    writer.publish(plain, bins.data(), nullptr, NUM_BINS);
+    SpectrumView view = {};
+    CHECK(reader.acquire_latest(view), "acquire after null-mask publish");
+    uint32_t unmeasured = 0;
+    for (uint32_t i = 0; i < view.info.num_bins; i++) {
+        if (!view.measured[i]) unmeasured++;
+    }
+    CHECK(unmeasured == 0, "null mask published %u unmeasured bins", unmeasured);
+
+    writer.close();
+    printf("✓ measured 마스크 게시 (nullptr = 전체 측정)\n");
+}
+
+void test_second_writer_refused() {
+    std::vector<float> bins(NUM_BINS);
+    std::vector<uint8_t> measured(NUM_BINS);
+
+    SpectrumShmWriter first;
+    CHECK(first.open(SHM_NAME, SHM_SLOTS, MAX_BINS, 70000000, 100000000, 61440000),
+          "writer open failed: %s", strerror(errno));
+    publish_sweep(first, bins, measured, 1);
+
+    SpectrumShmWriter second;
+    errno = 0;
+    CHECK(!second.open(SHM_NAME, SHM_SLOTS, MAX_BINS, 70000000, 100000000, 61440000),
+          "second writer attached to live segment");
+    CHECK(errno == EBUSY, "second writer errno %d, expected EBUSY", errno);
+    // 레이아웃이 달라도 살아 있는 writer의 세그먼트는 건드리지 않음
+    CHECK(!second.open(SHM_NAME, SHM_SLOTS, MAX_BINS * 2, 70000000, 100000000, 61440000),
+          "second writer replaced live segment");
+
+    SpectrumShmReader reader;
+    CHECK(reader.open(SHM_NAME), "reader open failed");
+    CHECK(reader.header()->writer_pid == (uint32_t)getpid(), "writer pid changed");
+    CHECK(reader.header()->max_bins == MAX_BINS, "live segment layout changed: %u", reader.header()->max_bins);
+    publish_sweep(first, bins, measured, 2);
+    SpectrumView view = {};
+    CHECK(reader.acquire_latest(view) && view.info.sequence == first.sequence(),
+          "first writer stopped publishing");
+
+    first.close();
+    printf("✓ 살아 있는 writer가 있으면 두 번째 writer 거부 (EBUSY)\n");
+}
+
+void test_dead_writer_taken_over() {
+    std::vector<float> bins(NUM_BINS);
+    std::vector<uint8_t> measured(NUM_BINS);
+
+    // 자식 프로세스가 writer로 게시 후 close 없이 종료 → writer_active = 1, pid는 죽음
+    shm_unlink(SHM_NAME);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        SpectrumShmWriter child;
+        if (!child.open(SHM_NAME, SHM_SLOTS, MAX_BINS, 70000000, 100000000, 61440000)) _exit(1);
+        for (uint64_t sweep = 1; sweep <= 5; sweep++) publish_sweep(child, bins, measured, sweep);
+        _exit(0);
+    }
+    int status = 0;
+    CHECK(pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0,
+          "child writer failed");
+
+    RawSegment raw;
+    CHECK(raw.map(SHM_NAME), "raw map failed: %s", strerror(errno));
+    if (!raw.base) return;
+    CHECK(raw.header()->writer_active.load() == 1 && raw.header()->writer_pid == (uint32_t)pid,
+          "dead writer state not left behind");
+
+    SpectrumShmWriter writer;
+    CHECK(writer.open(SHM_NAME, SHM_SLOTS, MAX_BINS, 70000000, 100000000, 61440000),
+          "writer refused dead writer's segment: %s", strerror(errno));
+    CHECK(writer.sequence() == 5, "sequence not continued: %llu", (unsigned long long)writer.sequence());
+    CHECK(raw.header()->writer_pid == (uint32_t)getpid(), "writer pid not updated");
+
+    writer.close();
+    printf("✓ 죽은 writer가 남긴 세그먼트 인수 (게시 번호 이어감)\n");
+}
+
+void test_layout_change_recreates() {
+    std::vector<float> bins(NUM_BINS);
+    std::vector<uint8_t> measured(NUM_BINS);
+
+    shm_unlink(SHM_NAME);
+    SpectrumShmWriter writer;
+    CHECK(writer.open(SHM_NAME, SHM_SLOTS, MAX_BINS, 70000000, 100000000, 61440000),
+          "writer open failed: %s", strerror(errno));
+    for (uint64_t sweep = 1; sweep <= 3; sweep++) publish_sweep(writer, bins, measured, sweep);
+    writer.close();
+
+    SpectrumShmReader old_reader;
+    CHECK(old_reader.open(SHM_NAME), "reader open failed");
+    if (!old_reader.header()) return;
+
+    // 더 작은 레이아웃: 기존 세그먼트를 ftruncate로 줄이면 옛 reader가 SIGBUS
+    CHECK(writer.open(SHM_NAME, SHM_SLOTS, NUM_BINS / 2, 70000000, 100000000, 61440000),
+          "writer open with new layout failed: %s", strerror(errno));
+    CHECK(writer.sequence() == 0, "new layout continued old sequence %llu",
+          (unsigned long long)writer.sequence());
+
+    // 옛 매핑은 그대로: 마지막 빈까지 읽어도 안전하고 게시 #3 그대로
+    SpectrumView view = {};
+    CHECK(old_reader.header()->max_bins == MAX_BINS, "old mapping header changed");
+    CHECK(old_reader.acquire_latest(view) && view.info.sequence == 3, "old mapping lost sweep 3");
+    CHECK(spectrum_shm_checksum(view.bins, view.measured, view.info.num_bins) == view.info.checksum,
+          "old mapping checksum mismatch");
+
+    SpectrumShmReader new_reader;
+    CHECK(new_reader.open(SHM_NAME), "reader open on new segment failed");
+    CHECK(new_reader.header()->max_bins == NUM_BINS / 2, "new segment max_bins %u",
+          new_reader.header()->max_bins);
+    CHECK(new_reader.latest_sequence() == 0, "new segment not empty");
+
+    writer.close();
+    printf("✓ 레이아웃 변경 시 새 세그먼트 생성, 옛 reader 매핑 유지\n");
+}
+
+int main() {
+    shm_unlink(SHM_NAME);
+    test_reopen_after_torn_publish();
+    test_publish_from_odd_seq();
+    test_measured_mask_published();
+    test_second_writer_refused();
+    test_dead_writer_taken_over();
+    test_layout_change_recreates();
+    shm_unlink(SHM_NAME);
+
+    return test_result();
+}
@@ -0,0 +1,254 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <vector>
+#include "alloc_counter.h"
+#include "fft_plan_cache.h"
+#include "spectrum_frontend.h"
+#include "sweep_pipeline.h"
+#include "sweep_scheduler.h"
+#include "occupancy_stats.h"
+#include "occupancy_checkpoint.h"
+#include "spectrum_shm.h"
+
+// ==================== 정상 상태 힙 할당 검사 ====================
+// 하드웨어 없이 스윕 스레드와 렌더 스레드가 쓰는 실제 함수들(sweep_pipeline.h)을 그대로 돌린다:
+// 잡음 기준선 측정 → 합성 IQ → average_frames → measure_step → 스케줄러 → stitch_step(스티칭 배열 + 측정 마스크)
+// → snapshot_spectrum(렌더 복사) → add_waterfall_line → 점유율 통계 → 공유 메모리 게시
+// → 점유율 체크포인트 요청 (스냅샷 복사만, 파일 쓰기는 writer 스레드 — 그 스레드의 할당은 세지 않음).
+// 워밍업 한 번 이후에는 operator new든 malloc 계열이든 한 번도 호출되지 않아야 한다 (실패 시 종료 코드 1).
+
+#define SAMPLE_RATE       61440000
+#define START_FREQ        80000000ULL
+#define END_FREQ          330000000ULL
+#define STEP_HZ           50000000ULL
+#define NUM_STEPS         (int)((END_FREQ - START_FREQ) / STEP_HZ + 1)
+#define FFT_SIZE          8192
+#define PFB_TAPS          8
+#define PFB_BIN_WIDTH     1.5
+#define DC_NOTCH_HZ       10000
+#define MAX_DWELL_CHUNKS  4
+#define WATERFALL_LINES   20
+#define MEASURED_SWEEPS   4
+#define SHM_NAME          "/bladerf_spectrum_alloctest"
+#define SHM_SLOTS         4
+#define CKPT_PATH         "test_steady_state_alloc.ckpt"
+
+static void* volatile alloc_sink;   // 컴파일러가 할당/해제 쌍을 지우지 못하도록
+
+struct alignas(64) AlignedBlock {
+    float values[16];
+};
+
+// 카운터가 일반/정렬/컨테이너/C 할당과 라이브러리 내부 할당을 모두 세는지 (검사가 공허하지 않은지)
+bool counter_sees_allocations() {
+    uint64_t before = alloc_counter::thread_allocations();
+
+    int* plain = new int(1);
+    alloc_sink = plain;
+    delete plain;
+
+    AlignedBlock* aligned = new AlignedBlock;
+    alloc_sink = aligned;
+    delete aligned;
+    uint64_t after_new = alloc_counter::thread_allocations();
+
+    std::vector<float> vec(16);
+    alloc_sink = vec.data();
+
+    void* c_block = malloc(64);
+    alloc_sink = c_block;
+    free(c_block);
+    uint64_t after_malloc = alloc_counter::thread_allocations();
+
+    char* copy = strdup("libc 내부 malloc");   // 라이브러리 안에서 호출되는 malloc
+    alloc_sink = copy;
+    free(copy);
+
+    uint64_t after = alloc_counter::thread_allocations();
+    printf("✓ 할당 카운터: new/정렬 new/vector/malloc/strdup 할당 %llu회 감지\n",
+           (unsigned long long)(after - before));
+    return after_new - before >= 2 && after_malloc - after_new >= 2 && after - after_malloc >= 1;
+}
+
+// 톤 두 개 + 약한 잡음 (결정적 LCG)
+void fill_synthetic_iq(int16_t* iq, int samples, int sweep, int step) {
+    uint32_t lcg = 12345u + sweep * 7919u + step * 104729u;
+    for (int n = 0; n < samples; n++) {
+        double phase_a = 2.0 * M_PI * (FFT_SIZE / 8.0 + step) * n / FFT_SIZE;
+        double phase_b = 2.0 * M_PI * (FFT_SIZE / 3.0) * n / FFT_SIZE;
+        lcg = lcg * 1664525u + 1013904223u;
+        int noise_i = (int)(lcg >> 28) - 8;
+        lcg = lcg * 1664525u + 1013904223u;
+        int noise_q = (int)(lcg >> 28) - 8;
+        double amp_b = (step == 2) ? 512.0 : 0.0;   // 스텝 2만 활동적
+        iq[2 * n] = (int16_t)(256.0 * cos(phase_a) + amp_b * cos(phase_b)) + noise_i;
+        iq[2 * n + 1] = (int16_t)(256.0 * sin(phase_a) + amp_b * sin(phase_b)) + noise_q;
+    }
+}
+
+// 스윕 한 번 (모든 스텝을 한 번 이상 방문할 때까지) — 스윕 스레드의 스텝/스윕 순서 그대로
+void run_sweep(int sweep, FftPlanCache& cache, WindowType window_type, FrontEnd frontend, DcMode dc_mode,
+               SweepScheduler& scheduler, StitchedSpectrum& spectrum, SweepArena& arena,
+               RenderSnapshot& snapshot, OccupancyStats& occupancy, SpectrumShmWriter& shm,
+               OccupancyCheckpointWriter& checkpoint_writer) {
+    FftSetup fft = cache.get(FFT_SIZE, window_type);
+    bool use_pfb = frontend == FRONTEND_PFB;
+    int taps = use_pfb ? PFB_TAPS : 1;
+    int spectrum_samples = FFT_SIZE * taps;
+    StitchRange range = stitch_range(FFT_SIZE, SAMPLE_RATE, STEP_HZ);
+    int dc_half_width = dc_half_width_bins(DC_NOTCH_HZ, FFT_SIZE, SAMPLE_RATE);
+
+    // 스윕 스레드는 구성이 바뀔 때마다 잡음 기준선을 다시 측정 (여기서는 스윕마다 구성이 바뀜)
+    calibrate_noise_baseline(scheduler, fft, use_pfb, dc_mode, dc_half_width, range,
+                             FFT_SIZE, spectrum_samples, arena);
+
+    size_t sweep_first_index = SIZE_MAX;
+    size_t sweep_last_index = 0;
+    std::fill(arena.measured.begin(), arena.measured.end(), 0);
+    spectrum.clear_sweep();
+    scheduler.begin_sweep();
+
+    while (!scheduler.coverage_complete()) {
+        SweepVisit visit = scheduler.next();
+        uint64_t freq = START_FREQ + visit.step * STEP_HZ;
+
+        // 한 번에 캡처: 프레임 간격 FFT_SIZE (PFB 프레임은 겹침)
+        fill_synthetic_iq(arena.iq_buffer.data(), (taps + visit.dwell_chunks - 1) * FFT_SIZE, sweep, visit.step);
+        average_frames(fft, use_pfb, dc_mode, dc_half_width, arena.iq_buffer.data(), FFT_SIZE,
+                       visit.dwell_chunks, arena.fft_result.data(), arena.avg_spectrum.data());
+
+        StepStats stats = measure_step(arena.avg_spectrum.data(), range);
+        StepActivity activity;
+        activity.mean_db = stats.mean_db;
+        activity.peak_db = stats.max_db;
+        activity.variance_db = stats.variance_db;
+        activity.dwell_chunks = visit.dwell_chunks;
+        scheduler.report(visit.step, activity);
+
+        StitchResult written = stitch_step(spectrum, arena.measured.data(), arena.avg_spectrum.data(),
+                                           FFT_SIZE, range, freq, true);
+        if (written.num_written > 0) {
+            if (written.first_index < sweep_first_index) sweep_first_index = written.first_index;
+            if (written.last_index > sweep_last_index) sweep_last_index = written.last_index;
+        }
+
+        // 렌더 스레드가 스텝마다 하는 복사
+        snapshot_spectrum(spectrum, true, snapshot);
+    }
+
+    spectrum.add_waterfall_line();
+    snapshot_spectrum(spectrum, true, snapshot);
+
+    double timestamp = 1.7e9 + sweep * 0.5;
+    occupancy.update(spectrum.full_spectrum.data(), arena.measured.data(),
+                     sweep_first_index, sweep_last_index, timestamp);
+
+    SpectrumSweepInfo info = {};
+    info.sweep_count = (uint64_t)sweep;
+    info.timestamp = timestamp;
+    info.start_hz = spectrum.array_start_hz();
+    info.hz_per_bin = spectrum.hz_per_array_bin();
+    info.fft_size = FFT_SIZE;
+    info.window_type = window_type;
+    info.frontend = frontend;
+    info.first_bin = (uint32_t)sweep_first_index;
+    info.last_bin = (uint32_t)sweep_last_index;
+    shm.publish(info, spectrum.full_spectrum.data(), arena.measured.data(),
+                (uint32_t)spectrum.full_spectrum.size());
+
+    // 이전 쓰기가 진행 중이면 건너뜀 (스윕 스레드와 같은 방식)
+    checkpoint_writer.submit(occupancy, CKPT_PATH);
+}
+
+int main() {
+    if (!counter_sees_allocations()) {
+        printf("❌ 할당 카운터가 할당을 세지 않음\n");
+        return 1;
+    }
+
+    // ========== 구성 (할당 허용) ==========
+    FftPlanCache cache(PFB_TAPS, PFB_BIN_WIDTH);
+
+    StitchedSpectrum spectrum;
+    spectrum.start_freq = START_FREQ;
+    spectrum.end_freq = END_FREQ;
+    spectrum.sample_rate = SAMPLE_RATE;
+    spectrum.waterfall_history = WATERFALL_LINES;
+    spectrum.configure_spectrum(FFT_SIZE);
+    size_t total_bins = spectrum.full_spectrum.size();
+
+    SweepArena arena;
+    arena.configure(FFT_SIZE, (size_t)(PFB_TAPS + MAX_DWELL_CHUNKS - 1) * FFT_SIZE, total_bins);
+
+    RenderSnapshot snapshot;
+    configure_render_snapshot(snapshot, total_bins, WATERFALL_LINES);
+
+    SweepSchedulerConfig scheduler_config;
+    scheduler_config.max_dwell_chunks = MAX_DWELL_CHUNKS;
+    SweepScheduler scheduler;
+    scheduler.configure(NUM_STEPS, scheduler_config);
+
+    OccupancyConfig occupancy_config;
+    occupancy_config.epoch_seconds = 1.0;   // 측정 구간에서 에포크 닫기도 거치도록
+    OccupancyStats occupancy;
+    occupancy.configure(total_bins, spectrum.array_start_hz(), spectrum.hz_per_array_bin(), occupancy_config);
+
+    OccupancyCheckpointWriter checkpoint_writer;
+    checkpoint_writer.prepare(occupancy);
+
+    SpectrumShmWriter shm;
+    if (!shm.open(SHM_NAME, SHM_SLOTS, (uint32_t)total_bins, START_FREQ, END_FREQ, SAMPLE_RATE)) {
+        printf("❌ 공유 메모리 생성 실패: %s (%s)\n", SHM_NAME, strerror(errno));
+        return 1;
+    }
+
+    // ========== 워밍업: 모든 윈도우/프런트엔드/DC 조합 한 번씩 ==========
+    int sweep = 0;
+    for (int w = 0; w < WINDOW_TYPE_COUNT; w++) {
+        for (int f = 0; f < FRONTEND_COUNT; f++) {
+            run_sweep(sweep, cache, (WindowType)w, (FrontEnd)f, (DcMode)(sweep % DC_MODE_COUNT),
+                      scheduler, spectrum, arena, snapshot, occupancy, shm, checkpoint_writer);
+            sweep++;
+        }
+    }
+
+    // ========== 측정: 이후 할당이 없어야 함 ==========
+    uint64_t before = alloc_counter::thread_allocations();
+    for (int repeat = 0; repeat < MEASURED_SWEEPS; repeat++) {
+        for (int w = 0; w < WINDOW_TYPE_COUNT; w++) {
+            for (int f = 0; f < FRONTEND_COUNT; f++) {
+                run_sweep(sweep, cache, (WindowType)w, (FrontEnd)f, (DcMode)(sweep % DC_MODE_COUNT),
+                          scheduler, spectrum, arena, snapshot, occupancy, shm, checkpoint_writer);
+                sweep++;
+            }
+        }
+    }
+    uint64_t steady_allocs = alloc_counter::thread_allocations() - before;
+
+    shm.close();
+    shm_unlink(SHM_NAME);
+    checkpoint_writer.stop();
+    remove(CKPT_PATH);
+
+    printf("  워밍업 이후 스윕 %d회 (스텝 %d개, 스티칭 배열 %zu빈, 표시 %zu점), 에포크 %d개, 게시 %llu회, "
+           "체크포인트 %llu회\n", MEASURED_SWEEPS * WINDOW_TYPE_COUNT * FRONTEND_COUNT, NUM_STEPS, total_bins,
+           snapshot.num_points, occupancy.epoch_count(), (unsigned long long)shm.sequence(),
+           (unsigned long long)checkpoint_writer.written());
+    if (checkpoint_writer.written() == 0) {
+        printf("❌ 체크포인트가 한 번도 저장되지 않음\n");
+        return 1;
+    }
+    if (snapshot.num_points == 0 || snapshot.waterfall_lines == 0) {
+        printf("❌ 렌더 스냅샷이 비어 있음\n");
+        return 1;
+    }
+    if (steady_allocs > 0) {
+        printf("❌ 정상 상태 힙 할당 %llu회 발생\n", (unsigned long long)steady_allocs);
+        return 1;
+    }
+    printf("✓ 정상 상태 힙 할당 없음\n");
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "sweep_scheduler.h"
+#include "test_check.h"
+
+// ==================== 적응형 스윕 스케줄러 검증 ====================
+// 합성 활동 패턴(스크립트된 StepActivity)을 넣어 스케줄러 결정을 결정적으로 검사
+// (실제 FFT 경로로 만든 잡음은 test_scheduler_noise.cpp)
+//  - 스윕마다 모든 스텝 방문 (커버리지)
+//  - 모든 재방문 간격 ≤ revisit_bound()
+//  - 활동 많은 스텝이 조용한 스텝보다 자주, 길게 방문됨
+//  - 같은 입력이면 같은 방문 순서 (결정성)
+
+#define NUM_STEPS     12
+#define NUM_SWEEPS    40
+
+struct RunResult {
+    std::vector<SweepVisit> visits;
+    std::vector<int> visit_count;
+    std::vector<int> dwell_sum;
+    uint64_t max_gap = 0;
+    uint64_t bound = 0;
+};
+
+// 스텝별 활동 스크립트: hot 스텝은 피크가 높고 분산이 크며 방문마다 레벨이 변함
+// 조용한 스텝은 실제 잡음 주기도 통계 (Hann, 스티칭 빈 ~6700개): 분산 ≈ 31/체류 dB²,
+// 피크 ≈ 평균 + 12 dB (체류가 길수록 낮아짐), 방문마다 조금씩 흔들림
+StepActivity scripted_activity(int step, int visit, int dwell_chunks, const std::vector<bool>& hot) {
+    StepActivity activity;
+    activity.dwell_chunks = dwell_chunks;
+    if (hot[step]) {
+        activity.mean_db = -70.0f + ((visit & 1) ? 5.0f : -5.0f);
+        activity.peak_db = activity.mean_db + 35.0f;
+        activity.variance_db = 80.0f;
+    } else {
+        float jitter = (float)((step * 7 + visit * 13) % 9 - 4) / 4.0f;   // -1 ~ +1
+        activity.mean_db = -90.0f + 0.05f * jitter;
+        activity.peak_db = activity.mean_db + 12.3f - 1.7f * (dwell_chunks - 1) + 0.8f * jitter;
+        activity.variance_db = 31.0f / dwell_chunks * (1.0f + 0.1f * jitter);
+    }
+    return activity;
+}
+
+SweepSchedulerConfig default_config() {
+    SweepSchedulerConfig config;
+    config.min_dwell_chunks = 1;
+    config.max_dwell_chunks = 4;
+    return config;
+}
+
+RunResult run(const std::vector<bool>& hot, const SweepSchedulerConfig& config = default_config()) {
+    SweepScheduler scheduler;
+    scheduler.configure(NUM_STEPS, config);
+
+    RunResult result;
+    result.visit_count.assign(NUM_STEPS, 0);
+    result.dwell_sum.assign(NUM_STEPS, 0);
+    result.bound = scheduler.revisit_bound();
+    std::vector<uint64_t> last_slot(NUM_STEPS, 0);
+
+    for (int sweep = 0; sweep < NUM_SWEEPS; sweep++) {
+        scheduler.begin_sweep();
+        std::vector<bool> seen(NUM_STEPS, false);
+
+        // 커버리지가 끝나지 않는 버그가 있어도 멈추도록 슬롯 수 제한
+        uint64_t slot_limit = result.bound * NUM_STEPS;
+        uint64_t slots = 0;
+        while (!scheduler.coverage_complete() && slots++ < slot_limit) {
+            SweepVisit visit = scheduler.next();
+            CHECK(visit.step >= 0 && visit.step < NUM_STEPS, "step out of range: %d", visit.step);
+            CHECK(visit.dwell_chunks >= config.min_dwell_chunks &&
+                  visit.dwell_chunks <= config.max_dwell_chunks,
+                  "dwell out of range: %d", visit.dwell_chunks);
+
+            uint64_t slot = scheduler.slot();
+            if (last_slot[visit.step] != 0) {
+                uint64_t gap = slot - last_slot[visit.step];
+                if (gap > result.max_gap) result.max_gap = gap;
+            }
+            last_slot[visit.step] = slot;
+
+            seen[visit.step] = true;
+            result.visits.push_back(visit);
+            result.visit_count[visit.step]++;
+            result.dwell_sum[visit.step] += visit.dwell_chunks;
+            scheduler.report(visit.step, scripted_activity(visit.step, result.visit_count[visit.step],
+                                                           visit.dwell_chunks, hot));
+        }
+
+        CHECK(scheduler.coverage_complete(), "sweep %d did not complete coverage", sweep);
+        for (int step = 0; step < NUM_STEPS; step++) {
+            CHECK(seen[step], "sweep %d skipped step %d", sweep, step);
+        }
+    }
+    return result;
+}
+
+void test_quiet_band() {
+    std::vector<bool> hot(NUM_STEPS, false);
+    RunResult result = run(hot);
+
+    // 활동이 없으면 스윕마다 각 스텝 한 번, 최소 체류
+    CHECK(result.visits.size() == (size_t)NUM_STEPS * NUM_SWEEPS,
+          "quiet band: %zu visits, expected %d", result.visits.size(), NUM_STEPS * NUM_SWEEPS);
+    for (int step = 0; step < NUM_STEPS; step++) {
+        CHECK(result.dwell_sum[step] == result.visit_count[step],
+              "quiet band: step %d dwell above minimum", step);
+    }
+    CHECK(result.max_gap <= result.bound, "quiet band: gap %llu > bound %llu",
+          (unsigned long long)result.max_gap, (unsigned long long)result.bound);
+    printf("✓ 조용한 대역: 방문 %zu회, 최대 재방문 간격 %llu (상한 %llu)\n", result.visits.size(),
+           (unsigned long long)result.max_gap, (unsigned long long)result.bound);
+}
+
+void test_active_steps() {
+    std::vector<bool> hot(NUM_STEPS, false);
+    hot[2] = true;
+    hot[9] = true;
+    RunResult result = run(hot);
+
+    double hot_visits = 0.0, quiet_visits = 0.0;
+    double hot_dwell = 0.0, quiet_dwell = 0.0;
+    int hot_steps = 0, quiet_steps = 0;
+    for (int step = 0; step < NUM_STEPS; step++) {
+        double mean_dwell = (double)result.dwell_sum[step] / result.visit_count[step];
+        if (hot[step]) {
+            hot_visits += result.visit_count[step];
+            hot_dwell += mean_dwell;
+            hot_steps++;
+        } else {
+            quiet_visits += result.visit_count[step];
+            quiet_dwell += mean_dwell;
+            quiet_steps++;
+        }
+    }
+    hot_visits /= hot_steps;
+    quiet_visits /= quiet_steps;
+    hot_dwell /= hot_steps;
+    quiet_dwell /= quiet_steps;
+
+    CHECK(hot_visits >= 2.0 * quiet_visits, "active steps: %.1f visits vs quiet %.1f",
+          hot_visits, quiet_visits);
+    CHECK(hot_dwell > quiet_dwell + 1.0, "active steps: dwell %.2f vs quiet %.2f",
+          hot_dwell, quiet_dwell);
+    CHECK(result.max_gap <= result.bound, "active steps: gap %llu > bound %llu",
+          (unsigned long long)result.max_gap, (unsigned long long)result.bound);
+    printf("✓ 활동 스텝: 스텝당 방문 %.1f회 (조용한 스텝 %.1f회), 평균 체류 %.2f (조용한 스텝 %.2f), "
+           "최대 재방문 간격 %llu (상한 %llu)\n", hot_visits, quiet_visits, hot_dwell, quiet_dwell,
+           (unsigned long long)result.max_gap, (unsigned long long)result.bound);
+}
+
+void test_all_active() {
+    // 모든 스텝이 활동적이어도 재방문 상한과 커버리지는 유지
+    std::vector<bool> hot(NUM_STEPS, true);
+    RunResult result = run(hot);
+    CHECK(result.max_gap <= result.bound, "all active: gap %llu > bound %llu",
+          (unsigned long long)result.max_gap, (unsigned long long)result.bound);
+    printf("✓ 전체 활동: 최대 재방문 간격 %llu (상한 %llu)\n",
+           (unsigned long long)result.max_gap, (unsigned long long)result.bound);
+}
+
+void test_heavy_bias() {
+    // 활동 가중치가 매우 크면 우선순위만으로는 조용한 스텝이 밀려남 → 강제 방문으로 상한 보장
+    SweepSchedulerConfig config = default_config();
+    config.activity_gain = 200.0f;
+    std::vector<bool> hot(NUM_STEPS, false);
+    hot[0] = true;
+    hot[1] = true;
+    hot[2] = true;
+    RunResult result = run(hot, config);
+
+    int forced = 0;
+    for (const SweepVisit& visit : result.visits) forced += visit.forced ? 1 : 0;
+    CHECK(forced > 0, "heavy bias: no forced visits");
+    CHECK(result.max_gap <= result.bound, "heavy bias: gap %llu > bound %llu",
+          (unsigned long long)result.max_gap, (unsigned long long)result.bound);
+    printf("✓ 강한 편향: 강제 방문 %d회, 최대 재방문 간격 %llu (상한 %llu)\n", forced,
+           (unsigned long long)result.max_gap, (unsigned long long)result.bound);
+}
+
+void test_deterministic() {
+    std::vector<bool> hot(NUM_STEPS, false);
+    hot[5] = true;
+    RunResult a = run(hot);
+    RunResult b = run(hot);
+
+    bool same = a.visits.size() == b.visits.size();
+    for (size_t i = 0; same && i < a.visits.size(); i++) {
+        same = a.visits[i].step == b.visits[i].step &&
+               a.visits[i].dwell_chunks == b.visits[i].dwell_chunks &&
+               a.visits[i].forced == b.visits[i].forced;
+    }
+    CHECK(same, "identical activity produced different visit sequences");
+    printf("✓ 결정성: 방문 순서 %zu개 동일\n", a.visits.size());
+}
+
+int main() {
+    test_quiet_band();
+    test_active_steps();
+    test_all_active();
+    test_heavy_bias();
+    test_deterministic();
+
+    return test_result();
+}